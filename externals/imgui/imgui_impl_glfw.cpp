@@ -161,7 +161,20 @@ void ImGui_ImplGlfwGL2_CharCallback(GLFWwindow*, unsigned int c)
 {
     ImGuiIO& io = ImGui::GetIO();
     if (c > 0 && c < 0x10000)
+    {
         io.AddInputCharacter((unsigned short)c);
+        ImGui::RequestGlyph((ImWchar)c);
+    }
+}
+
+// Registers the default font against the current glyph ranges; the
+// atlas rasterizes later, inside CreateDeviceObjects, on the first
+// NewFrame or after a range extension.
+static void ImGui_ImplGlfwGL2_SetupFonts()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.Fonts->AddFontDefault();
+    io.Fonts->ConfigData.back().GlyphRanges = ImGui::GetGlyphRangesStartup();
 }
 
 bool ImGui_ImplGlfwGL2_CreateDeviceObjects()
@@ -241,6 +254,8 @@ bool    ImGui_ImplGlfwGL2_Init(GLFWwindow* window, bool install_callbacks)
         glfwSetCharCallback(window, ImGui_ImplGlfwGL2_CharCallback);
     }
 
+    ImGui_ImplGlfwGL2_SetupFonts();
+
     return true;
 }
 
@@ -252,6 +267,15 @@ void ImGui_ImplGlfwGL2_Shutdown()
 
 void ImGui_ImplGlfwGL2_NewFrame()
 {
+    // A character outside the startup ranges showed up: re-register the
+    // font against the extended ranges and rebuild the atlas texture.
+    if (ImGui::GlyphRangesDirty())
+    {
+        ImGui::GetIO().Fonts->Clear();
+        ImGui_ImplGlfwGL2_SetupFonts();
+        ImGui_ImplGlfwGL2_InvalidateDeviceObjects();
+    }
+
     if (!g_FontTexture)
         ImGui_ImplGlfwGL2_CreateDeviceObjects();
 
@@ -11,10 +11,6 @@
 
 #include "imgui.h"
 #include "imgui_impl_glfw_gl3.h"
-#include "roboto_regular.ttf.h"
-#include "robotomono_regular.ttf.h" 
-#include "icons_kenney.ttf.h"
-#include "icons_font_awesome.ttf.h"
 
 // GL3W/GLFW
 #include <glad/glad.h>    // This example is using gl3w to access OpenGL functions (because it is small). You may use glew/glad/glLoadGen/etc. whatever already works for you.
@@ -38,6 +34,12 @@ static int          g_AttribLocationPosition = 0, g_AttribLocationUV = 0, g_Attr
 static unsigned int g_VboHandle = 0, g_VaoHandle = 0, g_ElementsHandle = 0;
 
 #ifdef USE_IM_GUI_OTHER_FONT
+// The embedded fonts only compile in when they're wanted; several MB of
+// ttf arrays otherwise.
+#include "roboto_regular.ttf.h"
+#include "robotomono_regular.ttf.h"
+#include "icons_kenney.ttf.h"
+#include "icons_font_awesome.ttf.h"
 #include "iconfontheaders/icons_kenney.h"
 #include "iconfontheaders/icons_font_awesome.h"
 
@@ -62,7 +64,21 @@ namespace ImGui
 	{
 		PushFont(m_font[_font]);
 	}
+}
+#else
+namespace ImGui
+{
+	// Without the extra fonts everything renders with the default font,
+	// so the named-font push degrades to a balanced no-op.
+	void PushFont(Font::Enum)
+	{
+		PushFont(GetFont());
+	}
+}
+#endif
 
+namespace ImGui
+{
 	// Use code bgfx imgui
 	void SetupStyle(bool _dark)
 	{
@@ -134,7 +150,6 @@ namespace ImGui
 		}
 	}
 }
-#endif
 
 // This is the main rendering function that you have to implement and provide to ImGui (via setting up 'RenderDrawListsFn' in the ImGuiIO structure)
 // If text or lines are blurry when integrating ImGui in your engine:
@@ -275,7 +290,10 @@ void ImGui_ImplGlfwGL3_CharCallback(GLFWwindow*, unsigned int c)
 {
     ImGuiIO& io = ImGui::GetIO();
     if (c > 0 && c < 0x10000)
+    {
         io.AddInputCharacter((unsigned short)c);
+        ImGui::RequestGlyph((ImWchar)c);
+    }
 }
 
 bool ImGui_ImplGlfwGL3_CreateFontsTexture()
@@ -312,8 +330,13 @@ bool ImGui_ImplGlfwGL3_CreateDeviceObjects()
     glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
     glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
 
+    // an es context rejects the desktop version line; the same bodies
+    // compile as 300 es once the fragment stage declares a precision
+    bool gles = strncmp((const char*)glGetString(GL_VERSION), "OpenGL ES", 9) == 0;
+    const GLchar* vertex_header = gles ? "#version 300 es\n" : "#version 330 core\n";
+    const GLchar* fragment_header = gles ? "#version 300 es\nprecision mediump float;\n" : "#version 330 core\n";
+
     const GLchar *vertex_shader =
-        "#version 330 core\n"
         "uniform mat4 ProjMtx;\n"
         "in vec2 Position;\n"
         "in vec2 UV;\n"
@@ -328,7 +351,6 @@ bool ImGui_ImplGlfwGL3_CreateDeviceObjects()
         "}\n";
 
     const GLchar* fragment_shader =
-        "#version 330 core\n"
         "uniform sampler2D Texture;\n"
         "in vec2 Frag_UV;\n"
         "in vec4 Frag_Color;\n"
@@ -338,11 +360,14 @@ bool ImGui_ImplGlfwGL3_CreateDeviceObjects()
         "	Out_Color = Frag_Color * texture( Texture, Frag_UV.st);\n"
         "}\n";
 
+    const GLchar* vertex_sources[2] = { vertex_header, vertex_shader };
+    const GLchar* fragment_sources[2] = { fragment_header, fragment_shader };
+
     g_ShaderHandle = glCreateProgram();
     g_VertHandle = glCreateShader(GL_VERTEX_SHADER);
     g_FragHandle = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(g_VertHandle, 1, &vertex_shader, 0);
-    glShaderSource(g_FragHandle, 1, &fragment_shader, 0);
+    glShaderSource(g_VertHandle, 2, vertex_sources, 0);
+    glShaderSource(g_FragHandle, 2, fragment_sources, 0);
     glCompileShader(g_VertHandle);
     glCompileShader(g_FragHandle);
     glAttachShader(g_ShaderHandle, g_VertHandle);
@@ -407,6 +432,44 @@ void    ImGui_ImplGlfwGL3_InvalidateDeviceObjects()
     }
 }
 
+// Registers the fonts against the current glyph ranges. Rasterization
+// happens later, inside CreateFontsTexture, on the first NewFrame or
+// after a range extension.
+static void ImGui_ImplGlfwGL3_SetupFonts()
+{
+    ImGuiIO& io = ImGui::GetIO();
+#ifdef USE_IM_GUI_OTHER_FONT
+	ImFontConfig config;
+	config.FontDataOwnedByAtlas = false;
+	config.MergeMode = false;
+	//			config.MergeGlyphCenterV = true;
+
+	float _fontSize = 18.f;
+	const ImWchar* ranges = ImGui::GlyphRangesExtended() ? io.Fonts->GetGlyphRangesCyrillic() : ImGui::GetGlyphRangesStartup();
+	m_font[ImGui::Font::Regular] = io.Fonts->AddFontFromMemoryTTF( (void*)s_robotoRegularTtf,     sizeof(s_robotoRegularTtf),     _fontSize,      &config, ranges);
+	m_font[ImGui::Font::Mono   ] = io.Fonts->AddFontFromMemoryTTF( (void*)s_robotoMonoRegularTtf, sizeof(s_robotoMonoRegularTtf), _fontSize-3.0f, &config, ranges);
+
+	config.MergeMode = true;
+	config.DstFont   = m_font[ImGui::Font::Regular];
+
+	for (uint32_t ii = 0; ii < sizeof(s_fontRangeMerge)/sizeof(s_fontRangeMerge[0]); ++ii)
+	{
+		const FontRangeMerge& frm = s_fontRangeMerge[ii];
+
+		io.Fonts->AddFontFromMemoryTTF( (void*)frm.data
+				, (int)frm.size
+				, _fontSize-3.0f
+				, &config
+				, frm.ranges
+				);
+	}
+#else
+	// The default font, clipped to the ranges the profiler UI uses.
+	io.Fonts->AddFontDefault();
+	io.Fonts->ConfigData.back().GlyphRanges = ImGui::GetGlyphRangesStartup();
+#endif
+}
+
 bool    ImGui_ImplGlfwGL3_Init(GLFWwindow* window, bool install_callbacks)
 {
     g_Window = window;
@@ -450,39 +513,9 @@ bool    ImGui_ImplGlfwGL3_Init(GLFWwindow* window, bool install_callbacks)
 
 	ImGui::SetupStyle(true);
 
-	uint8_t* data;
-	int32_t width;
-	int32_t height;
-	{
-#ifdef USE_IM_GUI_OTHER_FONT
-		ImFontConfig config;
-		config.FontDataOwnedByAtlas = false;
-		config.MergeMode = false;
-		//			config.MergeGlyphCenterV = true;
-
-		float _fontSize = 18.f;
-		const ImWchar* ranges = io.Fonts->GetGlyphRangesCyrillic();
-		m_font[ImGui::Font::Regular] = io.Fonts->AddFontFromMemoryTTF( (void*)s_robotoRegularTtf,     sizeof(s_robotoRegularTtf),     _fontSize,      &config, ranges);
-		m_font[ImGui::Font::Mono   ] = io.Fonts->AddFontFromMemoryTTF( (void*)s_robotoMonoRegularTtf, sizeof(s_robotoMonoRegularTtf), _fontSize-3.0f, &config, ranges);
-
-		config.MergeMode = true;
-		config.DstFont   = m_font[ImGui::Font::Regular];
-
-		for (uint32_t ii = 0; ii < sizeof(s_fontRangeMerge)/sizeof(s_fontRangeMerge[0]); ++ii)
-		{
-			const FontRangeMerge& frm = s_fontRangeMerge[ii];
-
-			io.Fonts->AddFontFromMemoryTTF( (void*)frm.data
-					, (int)frm.size
-					, _fontSize-3.0f
-					, &config
-					, frm.ranges
-					);
-		}
-#endif
-	}
-
-	io.Fonts->GetTexDataAsRGBA32(&data, &width, &height);
+	// Rasterization is deferred to the first NewFrame; init only
+	// registers the fonts against the startup glyph ranges.
+	ImGui_ImplGlfwGL3_SetupFonts();
 
 	ImGui::InitDockContext();
 
@@ -496,6 +529,22 @@ void ImGui_ImplGlfwGL3_Shutdown()
 
 void ImGui_ImplGlfwGL3_NewFrame()
 {
+    // A character outside the startup ranges showed up: re-register the
+    // fonts against the extended ranges and rebuild just the atlas
+    // texture; the other device objects stay.
+    if (ImGui::GlyphRangesDirty())
+    {
+        ImGui::GetIO().Fonts->Clear();
+        ImGui_ImplGlfwGL3_SetupFonts();
+        if (g_FontTexture)
+        {
+            glDeleteTextures(1, &g_FontTexture);
+            ImGui::GetIO().Fonts->TexID = 0;
+            g_FontTexture = 0;
+            ImGui_ImplGlfwGL3_CreateFontsTexture();
+        }
+    }
+
     if (!g_FontTexture)
         ImGui_ImplGlfwGL3_CreateDeviceObjects();
 
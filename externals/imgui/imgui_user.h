@@ -16,6 +16,15 @@ namespace ImGui
 
     void PushFont(Font::Enum _font);
 
+    // Lazy glyph ranges, shared by the GLFW bindings: the atlas bakes
+    // only the ASCII the profiler UI draws at startup; input characters
+    // beyond it request the full ranges and the binding rebuilds the
+    // atlas on the next frame.
+    const ImWchar* GetGlyphRangesStartup();
+    bool GlyphRangesExtended();
+    bool GlyphRangesDirty();
+    void RequestGlyph(ImWchar c);
+
     // BK - simple string class for convenience.
     class ImString
     {
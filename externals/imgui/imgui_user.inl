@@ -69,6 +69,38 @@ namespace ImGui
     {
         return NULL == Ptr;
     }
+
+    static bool s_GlyphRangesExtendedFlag = false;
+    static bool s_GlyphRangesWanted = false;
+
+    const ImWchar* GetGlyphRangesStartup()
+    {
+        // Plain ASCII covers everything the profiler UI renders; the
+        // default ranges only rasterize once something asks for more.
+        static const ImWchar ascii_ranges[] = { 0x0020, 0x007F, 0 };
+        return s_GlyphRangesExtendedFlag ? GetIO().Fonts->GetGlyphRangesDefault() : ascii_ranges;
+    }
+
+    bool GlyphRangesExtended()
+    {
+        return s_GlyphRangesExtendedFlag;
+    }
+
+    // Polled by the bindings each frame; flips to the extended ranges
+    // once and tells the caller to re-register fonts and re-upload.
+    bool GlyphRangesDirty()
+    {
+        if (!s_GlyphRangesWanted || s_GlyphRangesExtendedFlag)
+            return false;
+        s_GlyphRangesExtendedFlag = true;
+        return true;
+    }
+
+    void RequestGlyph(ImWchar c)
+    {
+        if (c > 0x7F)
+            s_GlyphRangesWanted = true;
+    }
 } // namespace
 
 #include "widgets/color_picker.inl"
@@ -0,0 +1,946 @@
+// headless renderer benchmark
+// runs each renderer variant across a num_frac sweep against a hidden
+// window and emits CSV we can diff across driver updates:
+//   renderer,num_frac,frames,cpu_ms,gpu_ms,draws_per_sec,hash
+
+#include "../ubo/renderer.h"
+
+#if USE_METAL
+#define GLFW_EXPOSE_NATIVE_COCOA
+#include <GLFW/glfw3native.h>
+#include "../ubo/renderer_metal.h"
+#endif
+
+#if USE_VULKAN
+#include "../ubo/renderer_vulkan.h"
+#endif
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+struct bench_result_t
+{
+    double cpu_ms;
+    double gpu_ms;
+    double draws_per_sec;
+};
+
+static const int bench_frames = 200;
+static const int bench_warmup_frames = 16;
+static const int bench_verify_frames = 4;
+static const int bench_sweep[] = { 10, 100, 1000, 10000 };
+
+// optional golden hashes, renderer,num_frac,hash per line; rows we
+// produce are checked against it and mismatches go to stderr, so a
+// rewrite that changes output fails the run even when it's faster
+struct golden_hashes_t
+{
+    struct entry_t
+    {
+        char name[32];
+        int frac;
+        uint64_t hash;
+    };
+
+    std::vector<entry_t> entries;
+
+    void load(const char* path)
+    {
+        FILE* fp = fopen(path, "r");
+        if (fp == NULL)
+            return;
+
+        char line[128];
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            entry_t entry;
+            unsigned long long hash = 0;
+            if (sscanf(line, "%31[^,],%d,%llx", entry.name, &entry.frac, &hash) == 3)
+            {
+                entry.hash = hash;
+                entries.push_back(entry);
+            }
+        }
+        fclose(fp);
+    }
+
+    const entry_t* find(const char* name, int frac) const
+    {
+        for (const auto& entry : entries)
+            if (strcmp(entry.name, name) == 0 && entry.frac == frac)
+                return &entry;
+        return nullptr;
+    }
+};
+
+static golden_hashes_t golden_hashes;
+static int hash_mismatches = 0;
+
+// render a few extra frames with the async readback armed, after the
+// timed window so none of the readback cost lands in the numbers. the
+// scene is a pure function of num_frac, so every frame must hash the
+// same; 0 means readback is unsupported or the output was unstable
+static uint64_t run_verify(renderer_opengl_t& render, GLFWwindow* window, capture_player_t* player)
+{
+    readback_hasher_t readback;
+    readback.setup();
+
+    for (int frame = 0; frame < bench_verify_frames; frame++)
+    {
+        if (player != nullptr)
+        {
+            // always the stream's first frame, so replay rows hash a
+            // fixed image too
+            player->rewind();
+            player->play_frame(render);
+        }
+        else
+        {
+            render_background_texture(render);
+        }
+        readback.capture(width, height);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    readback.finish();
+
+    uint64_t hash = readback.hashes.empty() ? 0 : readback.hashes[0];
+    for (uint64_t frame_hash : readback.hashes)
+        if (frame_hash != hash)
+            hash = 0;
+
+    readback.cleanup();
+    return hash;
+}
+
+static void check_golden(const char* name, int frac, uint64_t hash)
+{
+    const golden_hashes_t::entry_t* golden = golden_hashes.find(name, frac);
+    if (golden != nullptr && golden->hash != hash)
+    {
+        fprintf(stderr, "%s,%d: hash %016llx does not match golden %016llx\n",
+            name, frac, (unsigned long long)hash, (unsigned long long)golden->hash);
+        hash_mismatches++;
+    }
+}
+
+static bench_result_t run_bench(renderer_opengl_t& render, GLFWwindow* window, int frac)
+{
+    num_frac = frac;
+
+    GLuint query = 0;
+    bool has_timer_query = (glad_glGenQueries != nullptr) && (glGetQueryObjectui64v != nullptr);
+    if (has_timer_query)
+        glGenQueries(1, &query);
+
+    double cpu_total_ms = 0.0;
+    double gpu_total_ms = 0.0;
+    uint64_t draw_total = 0;
+
+    for (int frame = 0; frame < bench_warmup_frames + bench_frames; frame++)
+    {
+        bool measured = (frame >= bench_warmup_frames);
+
+#if USE_ALLOC_TRACKER
+        // measured frames run strict: one allocation is a regression
+        alloc_tracker.strict = measured;
+#endif
+
+        if (measured && has_timer_query)
+            glBeginQuery(GL_TIME_ELAPSED, query);
+
+        int64_t cpu_tick = cpu_clock.now_us();
+
+        render_background_texture(render);
+
+        int64_t cpu_tock = cpu_clock.now_us();
+
+        if (measured && has_timer_query)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+
+            // a bench can afford the sync point; it keeps the series gap-free
+            GLuint64 gpu_elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpu_elapsed);
+            gpu_total_ms += gpu_elapsed / 1e6;
+        }
+
+        if (measured)
+        {
+            cpu_total_ms += (cpu_tock - cpu_tick) / 1000.0;
+            draw_total += draw_count;
+        }
+
+        gpu_telemetry.sample(cpu_tock);
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+#if USE_ALLOC_TRACKER
+    alloc_tracker.strict = false;
+#endif
+
+    if (has_timer_query)
+        glDeleteQueries(1, &query);
+
+    bench_result_t result;
+    result.cpu_ms = cpu_total_ms / bench_frames;
+    result.gpu_ms = gpu_total_ms / bench_frames;
+    result.draws_per_sec = (result.gpu_ms > 0.0)
+        ? draw_total / (double)bench_frames / (result.gpu_ms * 1e-3)
+        : 0.0;
+    return result;
+}
+
+// capture replay: the recorded frames loop for the usual frame budget,
+// so the timing skeleton matches the synthetic sweep and rows stay
+// comparable across variants
+static bench_result_t run_capture_bench(renderer_opengl_t& render, GLFWwindow* window, capture_player_t& player)
+{
+    GLuint query = 0;
+    bool has_timer_query = (glad_glGenQueries != nullptr) && (glGetQueryObjectui64v != nullptr);
+    if (has_timer_query)
+        glGenQueries(1, &query);
+
+    double cpu_total_ms = 0.0;
+    double gpu_total_ms = 0.0;
+    uint64_t draw_total = 0;
+
+    player.rewind();
+
+    for (int frame = 0; frame < bench_warmup_frames + bench_frames; frame++)
+    {
+        bool measured = (frame >= bench_warmup_frames);
+
+#if USE_ALLOC_TRACKER
+        alloc_tracker.strict = measured;
+#endif
+
+        if (measured && has_timer_query)
+            glBeginQuery(GL_TIME_ELAPSED, query);
+
+        int64_t cpu_tick = cpu_clock.now_us();
+
+        if (!player.play_frame(render))
+        {
+            player.rewind();
+            player.play_frame(render);
+        }
+
+        int64_t cpu_tock = cpu_clock.now_us();
+
+        if (measured && has_timer_query)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+
+            GLuint64 gpu_elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpu_elapsed);
+            gpu_total_ms += gpu_elapsed / 1e6;
+        }
+
+        if (measured)
+        {
+            cpu_total_ms += (cpu_tock - cpu_tick) / 1000.0;
+            draw_total += draw_count;
+        }
+
+        gpu_telemetry.sample(cpu_tock);
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+#if USE_ALLOC_TRACKER
+    alloc_tracker.strict = false;
+#endif
+
+    if (has_timer_query)
+        glDeleteQueries(1, &query);
+
+    bench_result_t result;
+    result.cpu_ms = cpu_total_ms / bench_frames;
+    result.gpu_ms = gpu_total_ms / bench_frames;
+    result.draws_per_sec = (result.gpu_ms > 0.0)
+        ? draw_total / (double)bench_frames / (result.gpu_ms * 1e-3)
+        : 0.0;
+    return result;
+}
+
+// every variant gets a fresh hidden window so the gl2 and core-profile
+// renderers each run against a context they can actually use
+static GLFWwindow* create_bench_window(bool core_profile)
+{
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (core_profile)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    }
+    else
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    }
+
+    GLFWwindow* window = glfwCreateWindow(640, 480, "uno bench", NULL, NULL);
+    if (window == nullptr)
+        return nullptr;
+
+    glfwMakeContextCurrent(window);
+#if USE_SLIM_GL_LOADER
+    slim_gl_load((GLADloadproc)glfwGetProcAddress);
+#else
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+#endif
+    glfwSwapInterval(0);
+    glfwGetFramebufferSize(window, &width, &height);
+
+    return window;
+}
+
+// clock-stability gate: gpus ramp boost clocks over the first seconds
+// under load, and rows recorded during the ramp undercut every later
+// comparison against them. spin unmeasured frames until the sampled
+// graphics clock has held the telemetry stability window, bounded so a
+// machine with aggressive clock management cannot stall the run; where
+// nvml is unavailable the fixed warm-up frames remain the only gate
+static void wait_for_clock_stability(renderer_opengl_t& render, GLFWwindow* window)
+{
+    gpu_telemetry.sample(cpu_clock.now_us());
+    if (!gpu_telemetry.available)
+        return;
+
+    static const int64_t gate_limit_us = 15 * 1000000ll;
+    int64_t start_us = cpu_clock.now_us();
+    int frames = 0;
+
+    num_frac = 1000; // a mid-sweep load, so the gate ramps the clocks the run will see
+
+    while (!gpu_telemetry.stable())
+    {
+        int64_t now_us = cpu_clock.now_us();
+        if (now_us - start_us > gate_limit_us)
+        {
+            fprintf(stderr, "clock gate: not stable after %d frames, recording at %d MHz\n",
+                frames, gpu_telemetry.clock_mhz);
+            return;
+        }
+        render_background_texture(render);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        gpu_telemetry.sample(now_us);
+        frames++;
+    }
+
+    if (frames > 0)
+        fprintf(stderr, "clock gate: stable at %d MHz %dC after %d frames\n",
+            gpu_telemetry.clock_mhz, gpu_telemetry.temp_c, frames);
+}
+
+static void bench_renderer(const char* name, renderer_opengl_t& render, bool core_profile, const char* capture_path)
+{
+    GLFWwindow* window = create_bench_window(core_profile);
+
+    // window + context setup is a long enough interval even when glfw
+    // init alone was too quick; a no-op once calibrated
+    cpu_clock.calibrate();
+
+    if (window == nullptr)
+    {
+        fprintf(stderr, "%s: context creation failed, skipped\n", name);
+        return;
+    }
+
+    if (!render.setup())
+    {
+        fprintf(stderr, "%s: setup failed, skipped\n", name);
+        glfwDestroyWindow(window);
+        return;
+    }
+
+    wait_for_clock_stability(render, window);
+
+    if (capture_path != nullptr)
+    {
+        // the num_frac column reads "capture" in replay rows; the frame
+        // mix comes from the stream, not the sweep
+        capture_player_t player;
+        if (player.open(capture_path))
+        {
+            bench_result_t result = run_capture_bench(render, window, player);
+            uint64_t hash = run_verify(render, window, &player);
+            printf("%s,capture,%d,%.5f,%.5f,%.2f,%016llx\n",
+                name, bench_frames, result.cpu_ms, result.gpu_ms, result.draws_per_sec,
+                (unsigned long long)hash);
+            fflush(stdout);
+            // telemetry rides stderr so the csv schema stays parseable
+            if (gpu_telemetry.available)
+                fprintf(stderr, "%s,capture: gpu %d MHz %dC\n",
+                    name, gpu_telemetry.clock_mhz, gpu_telemetry.temp_c);
+        }
+        else
+        {
+            fprintf(stderr, "%s: cannot read capture %s, skipped\n", name, capture_path);
+        }
+    }
+    else
+    {
+        for (int frac : bench_sweep)
+        {
+            bench_result_t result = run_bench(render, window, frac);
+            uint64_t hash = run_verify(render, window, nullptr);
+            check_golden(name, frac, hash);
+            printf("%s,%d,%d,%.5f,%.5f,%.2f,%016llx\n",
+                name, frac, bench_frames, result.cpu_ms, result.gpu_ms, result.draws_per_sec,
+                (unsigned long long)hash);
+            fflush(stdout);
+            if (gpu_telemetry.available)
+                fprintf(stderr, "%s,%d: gpu %d MHz %dC\n",
+                    name, frac, gpu_telemetry.clock_mhz, gpu_telemetry.temp_c);
+        }
+    }
+
+    render.cleanup();
+
+#if USE_GL_OBJECT_TRACKER
+    // report per context: the next variant's window restarts gl names
+    // from 1, so stale entries would collide in the registry
+    gl_tracker.report(name);
+#endif
+
+    glfwDestroyWindow(window);
+}
+
+// paired A/B comparison (--ab): two variants interleaved frame-block by
+// frame-block in one process against the same frames, so slow clock
+// drift (boost states, thermals) lands on both sides of every pair
+// instead of on whichever variant ran second. the per-block means form
+// paired samples and the report carries a 95% confidence interval on
+// the delta — the gate that separates a real win from run-to-run noise
+// an aggregate-vs-aggregate comparison cannot see
+static const int ab_blocks = 12;
+static const int ab_block_frames = 16;
+static const int ab_block_warmup = 4;
+
+// two-sided 95% critical values of student's t; past 30 degrees of
+// freedom the normal approximation is within a percent
+static double t_critical_95(int df)
+{
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df <= 0)
+        return 0.0;
+    if (df <= 30)
+        return table[df - 1];
+    return 1.96;
+}
+
+// the variants the harness can name; mirrors the standard rows plus the
+// uniform-delivery strategies, since "is the ring really faster than
+// batched subdata" is exactly the question this mode exists to settle
+static renderer_opengl_t* create_ab_renderer(const char* name, bool* core_profile)
+{
+    *core_profile = true;
+    if (strcmp(name, "gl2") == 0)
+    {
+        *core_profile = false;
+        auto* render = new renderer_gl2_t();
+        render->kind = renderer_kind_gl2;
+        return render;
+    }
+    if (strcmp(name, "gl2_virtual") == 0)
+    {
+        *core_profile = false;
+        return new renderer_gl2_t();
+    }
+    if (strcmp(name, "gl3") == 0)
+        return new renderer_gl3_t();
+    if (strcmp(name, "gl31") == 0)
+        return new renderer_gl31_t();
+    if (strcmp(name, "gl31_pool") == 0)
+    {
+        auto* render = new renderer_gl31_pool_t();
+        render->kind = renderer_kind_gl31_pool;
+        return render;
+    }
+    if (strcmp(name, "uniform4fv") == 0)
+    {
+        auto* render = new renderer_gl3_t();
+        render->allow_uniform_ring = false;
+        render->allow_uniform_pool = false;
+        render->replay_enabled = false;
+        return render;
+    }
+    if (strcmp(name, "subdata_batched") == 0)
+    {
+        auto* render = new renderer_gl3_t();
+        render->allow_uniform_ring = false;
+        render->replay_enabled = false;
+        return render;
+    }
+    if (strcmp(name, "persistent_ring") == 0)
+    {
+        auto* render = new renderer_gl3_t();
+        render->replay_enabled = false;
+        return render;
+    }
+    return nullptr;
+}
+
+// one block of one side: a few unmeasured frames to settle the switch,
+// then the measured run. both sides play the same frames: either the
+// synthetic scene (pure function of num_frac) or the same capture
+// segment, each side advancing its own player in lockstep
+static void run_ab_block(renderer_opengl_t& render, GLFWwindow* window, capture_player_t* player,
+    GLuint query, bool has_timer_query, double* out_cpu_ms, double* out_gpu_ms)
+{
+    double cpu_total_ms = 0.0;
+    double gpu_total_ms = 0.0;
+
+    for (int frame = 0; frame < ab_block_warmup + ab_block_frames; frame++)
+    {
+        bool measured = (frame >= ab_block_warmup);
+
+        if (measured && has_timer_query)
+            glBeginQuery(GL_TIME_ELAPSED, query);
+
+        int64_t cpu_tick = cpu_clock.now_us();
+
+        if (player != nullptr)
+        {
+            if (!player->play_frame(render))
+            {
+                player->rewind();
+                player->play_frame(render);
+            }
+        }
+        else
+        {
+            render_background_texture(render);
+        }
+
+        int64_t cpu_tock = cpu_clock.now_us();
+
+        if (measured && has_timer_query)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+
+            GLuint64 gpu_elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpu_elapsed);
+            gpu_total_ms += gpu_elapsed / 1e6;
+        }
+
+        if (measured)
+            cpu_total_ms += (cpu_tock - cpu_tick) / 1000.0;
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    *out_cpu_ms = cpu_total_ms / ab_block_frames;
+    *out_gpu_ms = gpu_total_ms / ab_block_frames;
+}
+
+static void report_ab_metric(const char* name_a, const char* name_b, const char* metric,
+    const double* a, const double* b, int count)
+{
+    double mean_a = 0.0, mean_b = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        mean_a += a[i];
+        mean_b += b[i];
+    }
+    mean_a /= count;
+    mean_b /= count;
+
+    // paired: the statistic is the per-block delta, so common-mode
+    // drift across the run cancels instead of inflating the variance
+    double mean_diff = mean_b - mean_a;
+    double variance = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        double diff = (b[i] - a[i]) - mean_diff;
+        variance += diff * diff;
+    }
+    variance /= (count - 1);
+
+    double ci = t_critical_95(count - 1) * sqrt(variance / count);
+    bool significant = fabs(mean_diff) > ci;
+
+    printf("%s,%s,%s,%.5f,%.5f,%+.5f,%.5f,%s\n",
+        name_a, name_b, metric, mean_a, mean_b, mean_diff, ci,
+        significant ? "yes" : "no");
+    fflush(stdout);
+}
+
+static int run_ab(const char* name_a, const char* name_b, const char* capture_path)
+{
+    bool core_a = false, core_b = false;
+    renderer_opengl_t* render_a = create_ab_renderer(name_a, &core_a);
+    renderer_opengl_t* render_b = create_ab_renderer(name_b, &core_b);
+    if (render_a == nullptr || render_b == nullptr)
+    {
+        fprintf(stderr, "--ab: unknown variant %s\n", render_a == nullptr ? name_a : name_b);
+        delete render_a;
+        delete render_b;
+        return EXIT_FAILURE;
+    }
+
+    // both variants share one window and context — required for the
+    // interleave, so a pair that needs both context flavors cannot run
+    if (core_a != core_b)
+    {
+        fprintf(stderr, "--ab: %s and %s need different context profiles\n", name_a, name_b);
+        delete render_a;
+        delete render_b;
+        return EXIT_FAILURE;
+    }
+
+    GLFWwindow* window = create_bench_window(core_a);
+    cpu_clock.calibrate();
+    if (window == nullptr)
+    {
+        fprintf(stderr, "--ab: context creation failed\n");
+        delete render_a;
+        delete render_b;
+        return EXIT_FAILURE;
+    }
+
+    if (!render_a->setup() || !render_b->setup())
+    {
+        fprintf(stderr, "--ab: variant setup failed\n");
+        glfwDestroyWindow(window);
+        delete render_a;
+        delete render_b;
+        return EXIT_FAILURE;
+    }
+
+    // per-side players: each side performs its own texture creates, so
+    // the capture-id mapping cannot cross variants. both advance the
+    // same frame count per block and wrap at the same records
+    capture_player_t player_a, player_b;
+    bool replaying = false;
+    if (capture_path != nullptr)
+    {
+        replaying = player_a.open(capture_path) && player_b.open(capture_path);
+        if (!replaying)
+            fprintf(stderr, "--ab: cannot read capture %s, using the synthetic scene\n", capture_path);
+    }
+
+    GLuint query = 0;
+    bool has_timer_query = (glad_glGenQueries != nullptr) && (glGetQueryObjectui64v != nullptr);
+    if (has_timer_query)
+        glGenQueries(1, &query);
+
+    num_frac = 1000;
+
+    wait_for_clock_stability(*render_a, window);
+
+    double cpu_a[ab_blocks], cpu_b[ab_blocks];
+    double gpu_a[ab_blocks], gpu_b[ab_blocks];
+
+    for (int block = 0; block < ab_blocks; block++)
+    {
+        run_ab_block(*render_a, window, replaying ? &player_a : nullptr,
+            query, has_timer_query, &cpu_a[block], &gpu_a[block]);
+        run_ab_block(*render_b, window, replaying ? &player_b : nullptr,
+            query, has_timer_query, &cpu_b[block], &gpu_b[block]);
+    }
+
+    if (has_timer_query)
+        glDeleteQueries(1, &query);
+
+    printf("a,b,metric,a_ms,b_ms,delta_ms,ci95_ms,significant\n");
+    report_ab_metric(name_a, name_b, "cpu", cpu_a, cpu_b, ab_blocks);
+    if (has_timer_query)
+        report_ab_metric(name_a, name_b, "gpu", gpu_a, gpu_b, ab_blocks);
+
+    render_a->cleanup();
+    render_b->cleanup();
+    delete render_a;
+    delete render_b;
+
+#if USE_GL_OBJECT_TRACKER
+    gl_tracker.report("ab");
+#endif
+
+    glfwDestroyWindow(window);
+    return EXIT_SUCCESS;
+}
+
+// uniform delivery matrix (--uniforms): the same frame through every
+// strategy the tree carries, one row per strategy per num_frac. the
+// forced gl3 rows disable the frame cache so each measured frame pays
+// delivery; regenerated per driver, this table decides the shipping
+// configuration instead of a #define rebuild and a squint
+static void bench_uniform_matrix()
+{
+    {
+        // loose glUniform4fv per draw, the last-resort path
+        auto render = renderer_gl3_t();
+        render.allow_uniform_ring = false;
+        render.allow_uniform_pool = false;
+        render.replay_enabled = false;
+        bench_renderer("uniform4fv", render, true, nullptr);
+    }
+    {
+        // glBufferData reallocation per draw
+        auto render = renderer_gl31_t();
+        bench_renderer("bufferdata_per_draw", render, true, nullptr);
+    }
+    {
+        // one persistently mapped ubo, glBindBufferRange per draw
+        auto render = renderer_gl31_pool_t();
+        bench_renderer("mapped_bindrange", render, true, nullptr);
+    }
+    {
+        // staged client-side, one orphan + glBufferSubData batch upload
+        auto render = renderer_gl3_t();
+        render.allow_uniform_ring = false;
+        render.replay_enabled = false;
+        bench_renderer("subdata_batched", render, true, nullptr);
+    }
+    {
+        // persistently mapped ring, written once and bound in the
+        // submit loop
+        auto render = renderer_gl3_t();
+        render.replay_enabled = false;
+        bench_renderer("persistent_ring", render, true, nullptr);
+    }
+}
+
+#if USE_METAL
+// metal rows: the timer-query and readback columns are gl-only, so
+// gpu_ms, draws/s and the hash print as zeros and the cpu column
+// carries the comparison. the window is created without a gl context
+// and the backend presents its own drawable, so there is no swap here
+static void bench_metal(const char* name)
+{
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+    GLFWwindow* window = glfwCreateWindow(640, 480, "uno bench", NULL, NULL);
+    if (window == nullptr)
+    {
+        fprintf(stderr, "%s: window creation failed, skipped\n", name);
+        return;
+    }
+
+    glfwGetFramebufferSize(window, &width, &height);
+    cpu_clock.calibrate();
+
+    renderer_metal_t render;
+    render.native_window = glfwGetCocoaWindow(window);
+    if (!render.setup())
+    {
+        fprintf(stderr, "%s: setup failed, skipped\n", name);
+        glfwDestroyWindow(window);
+        return;
+    }
+
+    for (int frac : bench_sweep)
+    {
+        num_frac = frac;
+
+        double cpu_total_ms = 0.0;
+        for (int frame = 0; frame < bench_warmup_frames + bench_frames; frame++)
+        {
+            int64_t cpu_tick = cpu_clock.now_us();
+            render_background_texture(render);
+            int64_t cpu_tock = cpu_clock.now_us();
+
+            if (frame >= bench_warmup_frames)
+                cpu_total_ms += (cpu_tock - cpu_tick) / 1000.0;
+
+            glfwPollEvents();
+        }
+
+        printf("%s,%d,%d,%.5f,%.5f,%.2f,%016llx\n",
+            name, frac, bench_frames, cpu_total_ms / bench_frames, 0.0, 0.0, 0ull);
+        fflush(stdout);
+    }
+
+    render.cleanup();
+    glfwDestroyWindow(window);
+}
+#endif
+
+#if USE_VULKAN
+// vulkan rows: gpu_ms comes from the bridge's in-buffer timestamp pair,
+// but the readback hash is gl-only so it prints as zero and cpu_ms plus
+// gpu_ms carry the comparison. the backend owns its swapchain, so there
+// is no swap here either
+static void bench_vulkan(const char* name)
+{
+    if (!glfwVulkanSupported())
+    {
+        fprintf(stderr, "%s: no vulkan loader/icd, skipped\n", name);
+        return;
+    }
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+    GLFWwindow* window = glfwCreateWindow(640, 480, "uno bench", NULL, NULL);
+    if (window == nullptr)
+    {
+        fprintf(stderr, "%s: window creation failed, skipped\n", name);
+        return;
+    }
+
+    glfwGetFramebufferSize(window, &width, &height);
+    cpu_clock.calibrate();
+
+    renderer_vulkan_t render;
+    render.host_window = window;
+    if (!render.setup())
+    {
+        fprintf(stderr, "%s: setup failed, skipped\n", name);
+        glfwDestroyWindow(window);
+        return;
+    }
+
+    for (int frac : bench_sweep)
+    {
+        num_frac = frac;
+
+        double cpu_total_ms = 0.0;
+        double gpu_total_ms = 0.0;
+        for (int frame = 0; frame < bench_warmup_frames + bench_frames; frame++)
+        {
+            int64_t cpu_tick = cpu_clock.now_us();
+            render_background_texture(render);
+            int64_t cpu_tock = cpu_clock.now_us();
+
+            if (frame >= bench_warmup_frames)
+            {
+                cpu_total_ms += (cpu_tock - cpu_tick) / 1000.0;
+                gpu_total_ms += vulkan_bridge_gpu_ms();
+            }
+
+            glfwPollEvents();
+        }
+
+        printf("%s,%d,%d,%.5f,%.5f,%.2f,%016llx\n",
+            name, frac, bench_frames, cpu_total_ms / bench_frames,
+            gpu_total_ms / bench_frames, 0.0, 0ull);
+        fflush(stdout);
+    }
+
+    render.cleanup();
+    glfwDestroyWindow(window);
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    // glfw init provides the calibration interval; all the per-frame
+    // stamps below then cost a tsc read instead of a chrono call
+    cpu_clock.setup();
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    cpu_clock.calibrate();
+
+    // the bench honors on-device tuning the same way the sample does,
+    // so a sweep measures the configuration the box actually runs
+    tuning_load();
+
+    // with a capture file argument the sweep is replaced by the recorded
+    // frames, replayed identically against every variant
+    const char* capture_path = (argc > 1) ? argv[1] : nullptr;
+
+    golden_hashes.load("golden_hashes.csv");
+
+    // --ab <variant> <variant> [capture]: paired comparison of two
+    // configurations with a confidence interval on the delta
+    if (capture_path != nullptr && strcmp(capture_path, "--ab") == 0)
+    {
+        if (argc < 4)
+        {
+            fprintf(stderr, "usage: --ab <variant> <variant> [capture]\n");
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+        int result = run_ab(argv[2], argv[3], argc > 4 ? argv[4] : nullptr);
+        glfwTerminate();
+        exit(result);
+    }
+
+    if (capture_path != nullptr && strcmp(capture_path, "--uniforms") == 0)
+    {
+        printf("renderer,num_frac,frames,cpu_ms,gpu_ms,draws_per_sec,hash\n");
+        bench_uniform_matrix();
+        glfwTerminate();
+        exit(hash_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    printf("renderer,num_frac,frames,cpu_ms,gpu_ms,draws_per_sec,hash\n");
+
+    {
+        auto render = renderer_gl2_t();
+        render.kind = renderer_kind_gl2;
+        bench_renderer("gl2", render, false, capture_path);
+    }
+    {
+        // same backend, unstamped: the record loop dispatches every
+        // uniform/texture/submit through the vtable. the cpu_ms delta
+        // against the gl2 row is the measured dispatch cost
+        auto render = renderer_gl2_t();
+        bench_renderer("gl2_virtual", render, false, capture_path);
+    }
+    {
+        auto render = renderer_gl3_t();
+        bench_renderer("gl3", render, true, capture_path);
+    }
+    {
+        auto render = renderer_gl31_t();
+        bench_renderer("gl31", render, true, capture_path);
+    }
+    {
+        auto render = renderer_gl31_pool_t();
+        render.kind = renderer_kind_gl31_pool;
+        bench_renderer("gl31_pool", render, true, capture_path);
+    }
+
+#if USE_METAL
+    // captures record gl handles and the metal backend has no replay
+    // path yet, so only the synthetic sweep runs here
+    if (capture_path == nullptr)
+        bench_metal("metal");
+#endif
+
+#if USE_VULKAN
+    // same story as metal: no capture replay, synthetic sweep only
+    if (capture_path == nullptr)
+        bench_vulkan("vulkan");
+#endif
+
+    glfwTerminate();
+#if USE_ALLOC_TRACKER
+    // strict-mode ledger: any allocation inside a measured frame fails
+    // the run the same way a golden-hash mismatch does
+    if (alloc_tracker.strict_violations > 0)
+        fprintf(stderr, "%u allocations inside measured frames\n",
+            alloc_tracker.strict_violations);
+    exit(hash_mismatches == 0 && alloc_tracker.strict_violations == 0
+        ? EXIT_SUCCESS : EXIT_FAILURE);
+#else
+    exit(hash_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+}
@@ -0,0 +1,319 @@
+// renderer conformance and perf gate
+// runs the gl variants headless against the synthetic scene and fails
+// the process when either the rendered image or the per-frame call
+// profile drifts:
+//   - image: async-readback hashes must be stable across frames, agree
+//     across every variant at the same num_frac, and match
+//     golden_hashes.csv when one sits next to the binary
+//   - calls: a cached frame issues zero buffer uploads, any frame stays
+//     under a texture-bind ceiling, and a steady-state frame takes zero
+//     heap blocks out of the frame arena
+// the bench answers "how fast"; this target answers "still correct and
+// still batched", which is how the optimizations in renderer.h are kept
+// from silently regressing each other. exit status is pass/fail, so ci
+// can gate on the binary directly
+
+#include "../ubo/renderer.h"
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static const int gate_warmup_frames = 24;
+static const int gate_verify_frames = 4;
+static const int gate_sweep[] = { 10, 1000 };
+static const int gate_sweep_count = (int)(sizeof(gate_sweep) / sizeof(gate_sweep[0]));
+
+// the gradient frame holds four distinct textures; a sorted or shadowed
+// submission binds each a handful of times, a regression to per-draw
+// binding lands in the hundreds at num_frac 1000
+static const uint32_t gate_texture_bind_ceiling = 16;
+
+static int gate_checks = 0;
+static int gate_failures = 0;
+
+static void gate_check(bool ok, const char* name, int frac, const char* what)
+{
+    gate_checks++;
+    if (!ok)
+    {
+        fprintf(stderr, "FAIL %s,%d: %s\n", name, frac, what);
+        gate_failures++;
+    }
+}
+
+// cross-variant agreement: every backend must rasterize the same frame
+// bit-exact, so the first variant that hashes a num_frac sets the
+// reference and everyone after is compared against it
+static uint64_t reference_hash[gate_sweep_count];
+static const char* reference_owner[gate_sweep_count];
+
+// optional recorded goldens, same file and schema the bench checks
+// (renderer,num_frac,hash); present, it pins the output across runs
+// and machines instead of only across variants within this run
+struct golden_hashes_t
+{
+    struct entry_t
+    {
+        char name[32];
+        int frac;
+        uint64_t hash;
+    };
+
+    std::vector<entry_t> entries;
+
+    void load(const char* path)
+    {
+        FILE* fp = fopen(path, "r");
+        if (fp == NULL)
+            return;
+
+        char line[128];
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            entry_t entry;
+            unsigned long long hash = 0;
+            if (sscanf(line, "%31[^,],%d,%llx", entry.name, &entry.frac, &hash) == 3)
+            {
+                entry.hash = hash;
+                entries.push_back(entry);
+            }
+        }
+        fclose(fp);
+    }
+
+    const entry_t* find(const char* name, int frac) const
+    {
+        for (const auto& entry : entries)
+            if (strcmp(entry.name, name) == 0 && entry.frac == frac)
+                return &entry;
+        return nullptr;
+    }
+};
+
+static golden_hashes_t golden_hashes;
+
+struct gate_variant_t
+{
+    const char* name;
+    bool core_profile;
+
+    // display lists / the replay op stream: once warm, a frame with an
+    // unchanged generation must stop uploading geometry and uniforms
+    bool caches_frames;
+
+    // deferred recording through the frame arena: steady state must
+    // never fall back to the heap (immediate backends skip the check —
+    // they draw through the base quad path and never reset the arena)
+    bool arena_frames;
+
+    renderer_opengl_t* (*create)();
+};
+
+// same hidden-window flavors as the bench: gl2 records through client
+// arrays and lists, so it only runs against a compatibility context
+static GLFWwindow* create_gate_window(bool core_profile)
+{
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (core_profile)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    }
+    else
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    }
+
+    GLFWwindow* window = glfwCreateWindow(640, 480, "uno gate", NULL, NULL);
+    if (window == nullptr)
+        return nullptr;
+
+    glfwMakeContextCurrent(window);
+#if USE_SLIM_GL_LOADER
+    slim_gl_load((GLADloadproc)glfwGetProcAddress);
+#else
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+#endif
+#if USE_GL_CALL_COUNTER
+    gl_call_counter_install();
+#endif
+    glfwSwapInterval(0);
+    glfwGetFramebufferSize(window, &width, &height);
+
+    return window;
+}
+
+// hash a handful of post-warmup frames through the async readback; the
+// scene is a pure function of num_frac, so they must all agree. 0 means
+// the readback path itself is unavailable
+static uint64_t run_image_hash(renderer_opengl_t& render, GLFWwindow* window, bool* stable)
+{
+    readback_hasher_t readback;
+    readback.setup();
+    *stable = true;
+
+    for (int frame = 0; frame < gate_verify_frames; frame++)
+    {
+        render_background_texture(render);
+        readback.capture(width, height);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    readback.finish();
+
+    uint64_t hash = readback.hashes.empty() ? 0 : readback.hashes[0];
+    for (uint64_t frame_hash : readback.hashes)
+        if (frame_hash != hash)
+            *stable = false;
+
+    readback.cleanup();
+    return readback.supported() ? hash : 0;
+}
+
+static void gate_renderer(const gate_variant_t& variant)
+{
+    GLFWwindow* window = create_gate_window(variant.core_profile);
+    cpu_clock.calibrate();
+    if (window == nullptr)
+    {
+        // a machine that cannot hand out the context flavor skips the
+        // variant instead of failing the build on it
+        fprintf(stderr, "%s: context creation failed, skipped\n", variant.name);
+        return;
+    }
+
+    renderer_opengl_t* render = variant.create();
+    if (!render->setup())
+    {
+        fprintf(stderr, "%s: setup failed, skipped\n", variant.name);
+        delete render;
+        glfwDestroyWindow(window);
+        return;
+    }
+
+    for (int sweep = 0; sweep < gate_sweep_count; sweep++)
+    {
+        int frac = gate_sweep[sweep];
+        num_frac = frac;
+
+        for (int frame = 0; frame < gate_warmup_frames; frame++)
+        {
+            render_background_texture(*render);
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+
+        // one measured frame with nothing else on the context: the
+        // begin_frame inside rolled the counters, so the currents below
+        // cover exactly this frame
+        render_background_texture(*render);
+
+#if USE_GL_CALL_COUNTER
+        if (variant.caches_frames)
+            gate_check(gl_call_counter.current[gl_call_counter_t::cat_buffer] == 0,
+                variant.name, frac, "cached frame issued buffer uploads");
+#endif
+        gate_check(state_stats.texture_bind.issued <= gate_texture_bind_ceiling,
+            variant.name, frac, "texture binds above the sorted-submission ceiling");
+        if (variant.arena_frames)
+            gate_check(frame_arena.heap_events_last == 0,
+                variant.name, frac, "steady-state frame fell back to heap blocks");
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+
+        bool stable = true;
+        uint64_t hash = run_image_hash(*render, window, &stable);
+        if (hash == 0 && stable)
+        {
+            fprintf(stderr, "%s,%d: readback unsupported, image checks skipped\n", variant.name, frac);
+        }
+        else
+        {
+            gate_check(stable, variant.name, frac, "output not stable across frames");
+
+            if (reference_hash[sweep] == 0)
+            {
+                reference_hash[sweep] = hash;
+                reference_owner[sweep] = variant.name;
+            }
+            else
+            {
+                gate_check(hash == reference_hash[sweep],
+                    variant.name, frac, "image hash disagrees with the reference variant");
+                if (hash != reference_hash[sweep])
+                    fprintf(stderr, "  %s hashed %016llx, %s hashed %016llx\n",
+                        variant.name, (unsigned long long)hash,
+                        reference_owner[sweep], (unsigned long long)reference_hash[sweep]);
+            }
+
+            const golden_hashes_t::entry_t* golden = golden_hashes.find(variant.name, frac);
+            if (golden != nullptr)
+                gate_check(hash == golden->hash, variant.name, frac, "image hash does not match golden");
+        }
+
+        printf("%s,%d,%016llx\n", variant.name, frac, (unsigned long long)hash);
+        fflush(stdout);
+    }
+
+    render->cleanup();
+    delete render;
+
+#if USE_GL_OBJECT_TRACKER
+    gl_tracker.report(variant.name);
+#endif
+
+    glfwDestroyWindow(window);
+}
+
+// the stamped instances dispatch the record loop statically, matching
+// how the sample runs each backend; the gl3_record row disables the
+// frame cache so the recording path's call profile stays gated even
+// though the shipping configuration replays
+static renderer_opengl_t* create_gl2() { auto* r = new renderer_gl2_t(); r->kind = renderer_kind_gl2; return r; }
+static renderer_opengl_t* create_gl3() { auto* r = new renderer_gl3_t(); r->kind = renderer_kind_gl3; return r; }
+static renderer_opengl_t* create_gl3_record() { auto* r = new renderer_gl3_t(); r->kind = renderer_kind_gl3; r->replay_enabled = false; return r; }
+static renderer_opengl_t* create_gl31() { auto* r = new renderer_gl31_t(); r->kind = renderer_kind_gl31; return r; }
+static renderer_opengl_t* create_gl31_pool() { auto* r = new renderer_gl31_pool_t(); r->kind = renderer_kind_gl31_pool; return r; }
+
+static const gate_variant_t gate_variants[] = {
+    { "gl2",        false, true,  true,  create_gl2 },
+    { "gl3",        true,  true,  true,  create_gl3 },
+    { "gl3_record", true,  false, true,  create_gl3_record },
+    { "gl31",       true,  false, false, create_gl31 },
+    { "gl31_pool",  true,  false, false, create_gl31_pool },
+};
+
+int main()
+{
+    cpu_clock.setup();
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    cpu_clock.calibrate();
+
+    // deliberately no tuning_load: the gate asserts invariants of the
+    // default configuration, not of whatever a box was tuned to
+
+    golden_hashes.load("golden_hashes.csv");
+
+    printf("renderer,num_frac,hash\n");
+
+    for (const auto& variant : gate_variants)
+        gate_renderer(variant);
+
+    fprintf(stderr, "gate: %d checks, %d failed\n", gate_checks, gate_failures);
+
+    glfwTerminate();
+    exit(gate_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,192 @@
+// handle allocator micro-benchmark
+// times handle_alloc_t and its chunked-growth variant against a plain
+// lifo freelist under the churn patterns the renderer generates, at
+// table sizes picked to sit in L1, spill into L2, and blow past it.
+// emits CSV:
+//   allocator,pattern,handles,ns_op
+// the delta against the freelist is the price of stale-handle
+// detection (generations plus the sparse/dense bookkeeping); the
+// chunked column adds the cost of the chunk-table indirection on top
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include "handle_alloc.h"
+
+// baseline: lifo freelist, no generations, no sparse/dense arrays
+struct freelist_t
+{
+    explicit freelist_t(uint32_t max)
+    {
+        slots.resize(max);
+        for (uint32_t i = 0; i < max; i++)
+            slots[i] = max - 1 - i;
+    }
+
+    uint32_t alloc()
+    {
+        if (slots.empty())
+            return UINT32_MAX;
+        uint32_t slot = slots.back();
+        slots.pop_back();
+        return slot;
+    }
+
+    void free(uint32_t slot)
+    {
+        slots.push_back(slot);
+    }
+
+    std::vector<uint32_t> slots;
+};
+
+typedef std::chrono::high_resolution_clock bench_clock_t;
+
+static double to_ns_per_op(bench_clock_t::time_point begin, bench_clock_t::time_point end, uint64_t ops)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+    return ops ? (double)elapsed.count() / (double)ops : 0.0;
+}
+
+// enough repetitions that even the small tables accumulate a few
+// million timed operations
+static uint32_t reps_for(uint32_t count)
+{
+    uint64_t target_ops = 4000000;
+    uint64_t per_rep = 2ull * count;
+    uint64_t reps = target_ops / per_rep;
+    return reps < 1 ? 1 : (uint32_t)reps;
+}
+
+// alloc the whole table, then free in allocation order
+template <typename alloc_t>
+static double bench_sequential(alloc_t& alloc, uint32_t count, std::vector<uint32_t>& handles)
+{
+    uint32_t reps = reps_for(count);
+    auto begin = bench_clock_t::now();
+    for (uint32_t rep = 0; rep < reps; rep++)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            handles[i] = alloc.alloc();
+        for (uint32_t i = 0; i < count; i++)
+            alloc.free(handles[i]);
+    }
+    return to_ns_per_op(begin, bench_clock_t::now(), 2ull * count * reps);
+}
+
+// alloc the whole table, then free newest first
+template <typename alloc_t>
+static double bench_lifo(alloc_t& alloc, uint32_t count, std::vector<uint32_t>& handles)
+{
+    uint32_t reps = reps_for(count);
+    auto begin = bench_clock_t::now();
+    for (uint32_t rep = 0; rep < reps; rep++)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            handles[i] = alloc.alloc();
+        for (uint32_t i = count; i > 0; i--)
+            alloc.free(handles[i - 1]);
+    }
+    return to_ns_per_op(begin, bench_clock_t::now(), 2ull * count * reps);
+}
+
+// alloc the whole table, then free in a shuffled order
+template <typename alloc_t>
+static double bench_random(alloc_t& alloc, uint32_t count, std::vector<uint32_t>& handles)
+{
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; i++)
+        order[i] = i;
+    std::mt19937 rng(12345);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    uint32_t reps = reps_for(count);
+    auto begin = bench_clock_t::now();
+    for (uint32_t rep = 0; rep < reps; rep++)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            handles[i] = alloc.alloc();
+        for (uint32_t i = 0; i < count; i++)
+            alloc.free(handles[order[i]]);
+    }
+    return to_ns_per_op(begin, bench_clock_t::now(), 2ull * count * reps);
+}
+
+// hold the table at a given occupancy and replace random live handles,
+// the steady-state pattern of a scene creating and destroying textures
+template <typename alloc_t>
+static double bench_churn(alloc_t& alloc, uint32_t count, std::vector<uint32_t>& handles, uint32_t occupancy_pct)
+{
+    uint32_t live = count * occupancy_pct / 100;
+    if (live == 0)
+        live = 1;
+
+    for (uint32_t i = 0; i < live; i++)
+        handles[i] = alloc.alloc();
+
+    std::mt19937 rng(54321);
+    std::uniform_int_distribution<uint32_t> pick(0, live - 1);
+
+    uint64_t ops = 2ull * count * reps_for(count);
+    auto begin = bench_clock_t::now();
+    for (uint64_t op = 0; op < ops; op += 2)
+    {
+        uint32_t victim = pick(rng);
+        alloc.free(handles[victim]);
+        handles[victim] = alloc.alloc();
+    }
+    auto result = to_ns_per_op(begin, bench_clock_t::now(), ops);
+
+    for (uint32_t i = 0; i < live; i++)
+        alloc.free(handles[i]);
+    return result;
+}
+
+template <typename alloc_t>
+static void bench_patterns(const char* name, alloc_t& alloc, uint32_t count)
+{
+    std::vector<uint32_t> handles(count);
+
+    printf("%s,sequential,%u,%.2f\n", name, count, bench_sequential(alloc, count, handles));
+    printf("%s,lifo,%u,%.2f\n", name, count, bench_lifo(alloc, count, handles));
+    printf("%s,random,%u,%.2f\n", name, count, bench_random(alloc, count, handles));
+    printf("%s,churn50,%u,%.2f\n", name, count, bench_churn(alloc, count, handles, 50));
+    printf("%s,churn90,%u,%.2f\n", name, count, bench_churn(alloc, count, handles, 90));
+    fflush(stdout);
+}
+
+// the big instantiations hold megabytes of table, so they live on the
+// heap rather than the stack
+template <uint32_t count_t>
+static void bench_size()
+{
+    {
+        std::unique_ptr<handle_alloc_t<count_t>> alloc(new handle_alloc_t<count_t>());
+        bench_patterns("handle_alloc", *alloc, count_t);
+    }
+    {
+        // renderer-table-sized chunks; growth lands inside the first
+        // timed lap and amortizes across the reps
+        chunked_handle_alloc_t<256> alloc;
+        bench_patterns("chunked_alloc", alloc, count_t);
+    }
+    {
+        freelist_t alloc(count_t);
+        bench_patterns("freelist", alloc, count_t);
+    }
+}
+
+int main(void)
+{
+    printf("allocator,pattern,handles,ns_op\n");
+
+    bench_size<256>();       // in L1: dense+sparse+generation ~ 2 KB
+    bench_size<16384>();     // ~ 144 KB of table, spills into L2
+    bench_size<1048576>();   // ~ 9 MB, past L2 on everything we run
+    return 0;
+}
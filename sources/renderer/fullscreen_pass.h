@@ -0,0 +1,57 @@
+#pragma once
+
+// attributeless fullscreen pass: one oversized triangle generated in
+// the vertex shader from gl_VertexID — no buffer, no attribute state,
+// nothing for the caller to stream. glDrawArrays(GL_TRIANGLES, 0, 3)
+// against an empty vao is the whole draw, which makes it the template
+// for post-processing passes: the cost is all fill, never vertex fetch
+//
+// standalone on purpose: the thread sample includes this next to the
+// ubo renderers, so only gl entry points may be touched here
+
+static const char* const fullscreen_vertex_shader_code = R"__(
+#version 330 core
+
+out vec2 v_texcoord;
+
+void main()
+{
+    // ids 0,1,2 -> (-1,-1) (3,-1) (-1,3); the offscreen corners clip
+    // away and the surviving area covers the screen exactly once, with
+    // no diagonal seam to shade twice
+    vec2 position = vec2(
+        float((gl_VertexID & 1) << 2) - 1.0,
+        float((gl_VertexID & 2) << 1) - 1.0);
+    v_texcoord = position * 0.5 + 0.5;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)__";
+
+struct fullscreen_pass_t
+{
+    // core profiles refuse to draw without a vao; compatibility and
+    // es 2 run fine with none, so the name stays 0 there
+    GLuint vao = 0;
+
+    void setup()
+    {
+        if (glad_glGenVertexArrays != nullptr)
+            glGenVertexArrays(1, &vao);
+    }
+
+    void draw()
+    {
+        if (vao != 0)
+            glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    void cleanup()
+    {
+        if (vao != 0)
+        {
+            glDeleteVertexArrays(1, &vao);
+            vao = 0;
+        }
+    }
+};
@@ -0,0 +1,464 @@
+#pragma once
+
+// window-system context plumbing for the thread sample, extracted from
+// the wgl globals main.cpp used to carry so the threaded architecture
+// stops being windows-only. the split is by thread, not by call:
+// prepare() runs on the main thread before any render thread exists
+// (window-system objects that are main-thread-only on some platforms),
+// create()/create_shared() run on the thread that will own the
+// context, and swap()/swap_interval() run wherever the context is
+// current. windows keeps the hand-rolled wgl backend — the
+// pixel-format cache, the attrib probing and the shared loader
+// context all live there. everywhere else the window layer this
+// project already links does the platform work: glfw's context
+// backends are exactly glx/egl on linux and nsgl/cgl on macos, so a
+// second copy of that code here would only drift
+//
+// standalone on purpose, like gl_program.h: platform entry points and
+// the trace sink only
+
+#include "trace.h"
+
+#if _WIN32
+
+#include <windows.h>
+#include <Wingdi.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <GL/wglext.h>
+
+#pragma comment(lib, "opengl32.lib")
+
+// relaunch fast path: ChoosePixelFormat is where most of the ~100ms
+// of context startup goes — it probes the icd across every exposed
+// format — so the chosen index is cached on disk keyed by the display
+// adapter. wglGetProcAddress needs a live context, so the dummy
+// context survives on drivers that have wglCreateContextAttribsARB;
+// a driver cached as not having it skips the dummy entirely and goes
+// straight to the final legacy context. a stale cache (driver or gpu
+// swap under a kiosk) falls back to the full probe and rewrites
+struct wgl_config_cache_t
+{
+    static const char* path() { return "wgl_config.cache"; }
+
+    char key[256] = {};
+    int pixel_format = 0;
+    int has_context_attribs = -1; // -1 unknown: run the dummy dance
+
+    // adapter identity that exists before any context does
+    void build_key()
+    {
+        DISPLAY_DEVICEA device = {};
+        device.cb = sizeof(device);
+        if (EnumDisplayDevicesA(nullptr, 0, &device, 0))
+            snprintf(key, sizeof(key), "%s|%s", device.DeviceString, device.DeviceID);
+        else
+            snprintf(key, sizeof(key), "unknown");
+    }
+
+    bool load()
+    {
+        build_key();
+
+        FILE* file = fopen(path(), "r");
+        if (file == nullptr)
+            return false;
+
+        char stored[256] = {};
+        int format = 0, attribs = -1;
+        bool read_ok = fgets(stored, sizeof(stored), file) != nullptr
+            && fscanf(file, "%d %d", &format, &attribs) == 2;
+        fclose(file);
+
+        stored[strcspn(stored, "\r\n")] = 0;
+        if (!read_ok || strcmp(stored, key) != 0 || format <= 0)
+            return false;
+
+        pixel_format = format;
+        has_context_attribs = attribs;
+        return true;
+    }
+
+    void save(int format, int attribs)
+    {
+        FILE* file = fopen(path(), "w");
+        if (file == nullptr)
+            return;
+        fprintf(file, "%s\n%d %d\n", key, format, attribs);
+        fclose(file);
+    }
+};
+
+struct gl_context_t
+{
+    // nothing here needs the main thread; the hwnd arrives in create()
+    bool prepare(void*) { return true; }
+
+    bool create(void* window);
+    bool create_shared();
+
+    bool make_current()
+    {
+        if (wglMakeCurrent(hdc, context))
+            return true;
+        report_last_error();
+        return false;
+    }
+
+    bool make_current_shared()
+    {
+        if (shared != 0 && wglMakeCurrent(hdc, shared))
+            return true;
+        report_last_error();
+        return false;
+    }
+
+    void done_current()
+    {
+        wglMakeCurrent(NULL, NULL);
+    }
+
+    void swap()
+    {
+        SwapBuffers(hdc);
+    }
+
+    // HACK note inherited from glfw: with desktop composition enabled
+    // a wgl swap interval on top of DWM's own vsync double-throttles,
+    // which is why the dwm present mode keeps the interval at 0 and
+    // blocks on DwmFlush instead
+    void swap_interval(int interval)
+    {
+        if (SwapIntervalEXT != nullptr)
+            SwapIntervalEXT(interval);
+    }
+
+    void destroy_shared()
+    {
+        if (shared) {
+            wglDeleteContext(shared);
+            shared = 0;
+        }
+    }
+
+    void destroy()
+    {
+        // NOTE:
+        // if you make two consecutive wlgMakeCurrent(NULL, NULL) calls,
+        // An invalid handle error may occur.
+        // But it seems to work well.
+        wglMakeCurrent(NULL, NULL);
+        destroy_shared();
+        if (context) {
+            wglDeleteContext(context);
+            context = NULL;
+        }
+        if (hwnd && hdc) {
+            ReleaseDC(hwnd, hdc);
+            hdc = NULL;
+        }
+        hwnd = NULL;
+    }
+
+    const char* adapter() const { return adapter_name; }
+
+    static void report_last_error()
+    {
+        LPSTR lpMessageBuffer = nullptr;
+        DWORD dwError = GetLastError();
+
+        if (dwError == 0) {
+            return;
+        }
+        FormatMessage(
+            FORMAT_MESSAGE_ALLOCATE_BUFFER |
+            FORMAT_MESSAGE_FROM_SYSTEM |
+            FORMAT_MESSAGE_IGNORE_INSERTS,
+            nullptr,
+            dwError,
+            MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+            lpMessageBuffer,
+            0, nullptr
+        );
+
+        trace("Windows error code: %d . %s\n", dwError, lpMessageBuffer);
+        LocalFree(lpMessageBuffer);
+    }
+
+    HDC hdc = 0;
+    HWND hwnd = 0;
+    HGLRC context = 0;
+    HGLRC shared = 0;
+    PFNWGLSWAPINTERVALEXTPROC SwapIntervalEXT = 0;
+    PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribs = 0;
+    char adapter_name[128] = "unknown";
+};
+
+inline bool gl_context_t::create(void* window)
+{
+    PIXELFORMATDESCRIPTOR pfd = {
+        sizeof(PIXELFORMATDESCRIPTOR),
+        1,
+        PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,    // Flags
+        PFD_TYPE_RGBA,        // The kind of framebuffer. RGBA or palette.
+        32,                   // Colordepth of the framebuffer.
+        0, 0, 0, 0, 0, 0,
+        0,
+        0,
+        0,
+        0, 0, 0, 0,
+        24,                   // Number of bits for the depthbuffer
+        0,                    // Number of bits for the stencilbuffer
+        0,                    // Number of Aux buffers in the framebuffer.
+        PFD_MAIN_PLANE,
+        0,
+        0, 0, 0
+    };
+
+    hwnd = reinterpret_cast<HWND>(window);
+    hdc = ::GetDC(hwnd);
+
+    wgl_config_cache_t cache;
+    bool cached = cache.load();
+
+    int pixelFormat = cached ? cache.pixel_format : ChoosePixelFormat(hdc, &pfd);
+    if (!pixelFormat)
+        return false;
+    if (!DescribePixelFormat(hdc, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd)
+        || !SetPixelFormat(hdc, pixelFormat, &pfd))
+    {
+        // a cached index the driver rejects means the cache went stale
+        // under us; run the probe once and rewrite below
+        if (!cached)
+            return false;
+        cached = false;
+        cache.has_context_attribs = -1;
+        pixelFormat = ChoosePixelFormat(hdc, &pfd);
+        if (!pixelFormat
+            || !DescribePixelFormat(hdc, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd)
+            || !SetPixelFormat(hdc, pixelFormat, &pfd))
+            return false;
+    }
+
+    // the dummy exists to resolve wglCreateContextAttribsARB, nothing
+    // else; a driver cached as not having it skips straight to the
+    // final legacy context
+    if (cache.has_context_attribs != 0)
+    {
+        HGLRC dummyContext = wglCreateContext(hdc);
+        if (!dummyContext)
+            return false;
+
+        if (!wglMakeCurrent(hdc, dummyContext))
+        {
+            wglDeleteContext(dummyContext);
+            destroy();
+            return false;
+        }
+
+        wglCreateContextAttribs = (PFNWGLCREATECONTEXTATTRIBSARBPROC)wglGetProcAddress("wglCreateContextAttribsARB");
+
+        if (wglCreateContextAttribs)
+        {
+            int attribs[] = {
+                WGL_CONTEXT_MAJOR_VERSION_ARB, 4,
+                WGL_CONTEXT_MINOR_VERSION_ARB, 1,
+                WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_DEBUG_BIT_ARB,
+                WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
+                0, 0
+            };
+
+            context = wglCreateContextAttribs(hdc, nullptr, attribs);
+        }
+
+        wglMakeCurrent(NULL, NULL);
+        wglDeleteContext(dummyContext);
+        dummyContext = nullptr;
+    }
+
+    if (!context && !wglCreateContextAttribs)
+        context = wglCreateContext(hdc);
+
+    if (!context || !wglMakeCurrent(hdc, context)) {
+        DWORD dwError = GetLastError();
+        if (dwError == (0xc0070000 | ERROR_INVALID_VERSION_ARB))
+            trace("WGL: Driver does not support OpenGL version");
+        else if (dwError == (0xc0070000 | ERROR_INVALID_PROFILE_ARB))
+            trace("WGL: Driver does not support the requested OpenGL profile");
+        else if (dwError == (0xc0070000 | ERROR_INCOMPATIBLE_DEVICE_CONTEXTS_ARB))
+            trace("WGL: The share context is not compatible with the requested context");
+        else
+            trace("WGL: Failed to create OpenGL context");
+        destroy();
+        return false;
+    }
+
+    // the remaining wgl procs resolve fine against the real context
+    SwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC)wglGetProcAddress("wglSwapIntervalEXT");
+
+    // WGL_NV_gpu_affinity enumerates the physical gpus behind the
+    // driver. an affinity context cannot present to a window — it
+    // renders to fbos only — so the exported high-performance symbols
+    // in the sample stay the mechanism that pins the windowed context;
+    // the enumeration goes to the log so a wrong pick is visible next
+    // to the GL_RENDERER line below
+    auto wglEnumGpus = (PFNWGLENUMGPUSNVPROC)wglGetProcAddress("wglEnumGpusNV");
+    auto wglEnumGpuDevices = (PFNWGLENUMGPUDEVICESNVPROC)wglGetProcAddress("wglEnumGpuDevicesNV");
+    if (wglEnumGpus != nullptr && wglEnumGpuDevices != nullptr)
+    {
+        HGPUNV gpu = 0;
+        for (UINT i = 0; wglEnumGpus(i, &gpu); i++)
+        {
+            GPU_DEVICE device = {};
+            device.cb = sizeof(device);
+            for (UINT j = 0; wglEnumGpuDevices(gpu, j, &device); j++)
+                trace("WGL: gpu %u: %s (%s)%s\n", i,
+                    device.DeviceString, device.DeviceName,
+                    (device.Flags & DISPLAY_DEVICE_PRIMARY_DEVICE) ? " [primary]" : "");
+        }
+    }
+
+    gladLoadGL();
+
+    const GLubyte* renderer_string = glGetString(GL_RENDERER);
+    if (renderer_string != nullptr)
+        snprintf(adapter_name, sizeof(adapter_name), "%s", renderer_string);
+    trace("WGL: context on %s%s\n", adapter_name, cached ? " (cached format)" : "");
+
+    if (!cached)
+        cache.save(pixelFormat, wglCreateContextAttribs != nullptr ? 1 : 0);
+
+    return true;
+}
+
+// second context for the loader thread, sharing the render context's
+// object namespace: a texture the loader creates is a real name in the
+// render context the moment its fence signals. the attrib path passes
+// the render context as the share argument; the legacy path falls back
+// to wglShareLists before the loader context ever goes current
+inline bool gl_context_t::create_shared()
+{
+    if (wglCreateContextAttribs)
+    {
+        int attribs[] = {
+            WGL_CONTEXT_MAJOR_VERSION_ARB, 4,
+            WGL_CONTEXT_MINOR_VERSION_ARB, 1,
+            WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_DEBUG_BIT_ARB,
+            WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
+            0, 0
+        };
+
+        shared = wglCreateContextAttribs(hdc, context, attribs);
+    }
+    else
+    {
+        shared = wglCreateContext(hdc);
+        if (shared && !wglShareLists(context, shared))
+        {
+            wglDeleteContext(shared);
+            shared = 0;
+        }
+    }
+
+    if (!shared)
+        trace("WGL: Failed to create shared loader context");
+
+    return shared != 0;
+}
+
+#else // glfw carries glx/egl on linux and nsgl/cgl on macos
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+struct gl_context_t
+{
+    // called right after the main window, while its hints are still in
+    // effect, so the hidden share window gets an identical context.
+    // window creation is main-thread-only on macos, which is why the
+    // loader's window exists before the render thread does. a failure
+    // here is not fatal: the sample degrades to inline uploads
+    bool prepare(void* window)
+    {
+        main_window = (GLFWwindow*)window;
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        shared_window = glfwCreateWindow(1, 1, "uno loader", NULL, main_window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (shared_window == nullptr)
+            trace("GL: no shared loader context; uploads run inline\n");
+        return true;
+    }
+
+    bool create(void* window)
+    {
+        main_window = (GLFWwindow*)window;
+        glfwMakeContextCurrent(main_window);
+        gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+
+        const GLubyte* renderer_string = glGetString(GL_RENDERER);
+        if (renderer_string != nullptr)
+            snprintf(adapter_name, sizeof(adapter_name), "%s", renderer_string);
+        trace("GL: context on %s\n", adapter_name);
+        return true;
+    }
+
+    // the window-system work already happened in prepare(); this just
+    // answers whether the loader has a context to go current on
+    bool create_shared()
+    {
+        return shared_window != nullptr;
+    }
+
+    bool make_current()
+    {
+        glfwMakeContextCurrent(main_window);
+        return true;
+    }
+
+    bool make_current_shared()
+    {
+        if (shared_window == nullptr)
+            return false;
+        glfwMakeContextCurrent(shared_window);
+        return true;
+    }
+
+    void done_current()
+    {
+        glfwMakeContextCurrent(NULL);
+    }
+
+    void swap()
+    {
+        glfwSwapBuffers(main_window);
+    }
+
+    // applies to the calling thread's current context, matching the
+    // wgl backend's semantics
+    void swap_interval(int interval)
+    {
+        glfwSwapInterval(interval);
+    }
+
+    // the hidden window comes down with destroy(): glfwDestroyWindow
+    // is main-thread-only on macos and destroy() runs there
+    void destroy_shared() { }
+
+    void destroy()
+    {
+        if (shared_window != nullptr)
+        {
+            glfwDestroyWindow(shared_window);
+            shared_window = nullptr;
+        }
+        main_window = nullptr;
+    }
+
+    const char* adapter() const { return adapter_name; }
+
+    GLFWwindow* main_window = nullptr;
+    GLFWwindow* shared_window = nullptr;
+    char adapter_name[128] = "unknown";
+};
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+// shared shader plumbing: compile, link, and the failure logging, in
+// one place instead of a copy per sample. the thread sample and every
+// ubo backend compile through these; renderer_opengl_t keeps thin
+// virtuals on top so backends can still hook the chokepoint (the es
+// translation and the parallel-compile path both do)
+//
+// standalone on purpose, like fullscreen_pass.h: only gl entry points
+// and the trace sink may be touched here
+
+#include "trace.h"
+
+inline bool gl_shader_compiled(GLuint id)
+{
+    GLint compiled = 0;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &compiled);
+    if (compiled == GL_FALSE)
+    {
+        GLint length = 0;
+        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
+        std::vector<GLchar> buffer(length + 1);
+        glGetShaderInfoLog(id, length, 0, buffer.data());
+        trace("%s (%d) %s\n", __FILE__, __LINE__, buffer.data());
+        return false;
+    }
+    return true;
+}
+
+inline GLuint gl_create_shader(GLenum type, const char* shaderCode)
+{
+    GLuint id = glCreateShader(type);
+    if (id == 0)
+        return 0;
+
+    glShaderSource(id, 1, &shaderCode, 0);
+    glCompileShader(id);
+
+    if (!gl_shader_compiled(id))
+    {
+        glDeleteShader(id);
+        return 0;
+    }
+    return id;
+}
+
+inline GLuint gl_create_program(GLuint vertex, GLuint fragment)
+{
+    GLuint id = glCreateProgram();
+
+    GLint status = 0;
+    if (vertex != 0)
+    {
+        glAttachShader(id, vertex);
+        if (fragment != 0)
+            glAttachShader(id, fragment);
+        glLinkProgram(id);
+        glGetProgramiv(id, GL_LINK_STATUS, &status);
+
+        if (status == GL_FALSE)
+        {
+            const uint32_t kBufferSize = 512u;
+            char log[kBufferSize];
+            glGetProgramInfoLog(id, sizeof(log), nullptr, log);
+            trace("%s:%d %d: %s", __FILE__, __LINE__, status, log);
+            return 0;
+        }
+    }
+
+    if (status == GL_FALSE)
+    {
+        glDeleteProgram(id);
+        id = 0;
+        return id;
+    }
+
+    return id;
+}
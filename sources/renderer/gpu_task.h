@@ -0,0 +1,127 @@
+#pragma once
+
+// resumable multi-frame operations without the flag tangles: a task is
+// an ordered chain of stages, each polled once per scheduler tick until
+// it reports done, so "issue, wait for the gpu, consume" writes as
+// three lambdas instead of a bool per transition and a conditional per
+// bool. stackless and c++11 — a stage is a plain std::function and the
+// "coroutine state" is just the index of the stage being polled.
+//
+// the tight query/fence rings (gpu_timer_pool_t, gl_watchdog_t) stay
+// hand-rolled on purpose: they recycle a fixed pool every frame and a
+// task per query would allocate in the hot loop. this layer is for the
+// one-shot operations that span an unknown number of frames — capture
+// lifecycles, async readbacks, streaming waits — where composition
+// matters more than the last nanosecond
+//
+// standalone on purpose: no gl types, so cpu-side waits schedule the
+// same way
+
+#include <functional>
+#include <vector>
+
+#include "object_pool.h"
+
+struct gpu_task_t
+{
+    enum status_t
+    {
+        status_pending = 0, // poll again next tick
+        status_done,        // advance to the next stage
+    };
+
+    typedef std::function<status_t()> stage_t;
+
+    // raw stage; full control over when it completes
+    gpu_task_t& stage(stage_t s)
+    {
+        stages.push_back(std::move(s));
+        return *this;
+    }
+
+    // polled until the predicate holds — the co_await of this layer
+    gpu_task_t& await(std::function<bool()> ready)
+    {
+        stages.push_back([ready]() {
+            return ready() ? status_done : status_pending;
+        });
+        return *this;
+    }
+
+    // runs once and completes in the same poll
+    gpu_task_t& then(std::function<void()> work)
+    {
+        stages.push_back([work]() {
+            work();
+            return status_done;
+        });
+        return *this;
+    }
+
+    // one poll; true once the whole chain has run. a completing stage
+    // cascades straight into the next one, so a wait that is already
+    // satisfied does not cost an extra frame
+    bool poll()
+    {
+        while (current < stages.size())
+        {
+            if (stages[current]() == status_pending)
+                return false;
+            current++;
+        }
+        return true;
+    }
+
+    std::vector<stage_t> stages;
+    size_t current = 0;
+};
+
+struct gpu_task_scheduler_t
+{
+    gpu_task_scheduler_t() :
+        pool("gpu tasks")
+    {
+    }
+
+    ~gpu_task_scheduler_t() { clear(); }
+
+    // the reference stays valid while the caller chains stages onto it;
+    // pool blocks never move, so a running stage spawning a new task
+    // never invalidates anything
+    gpu_task_t& spawn()
+    {
+        tasks.push_back(pool.alloc());
+        return *tasks.back();
+    }
+
+    // poll every live task once; finished ones go back to the pool.
+    // called once per frame from the main loop
+    void tick()
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            if (!tasks[i]->poll())
+                tasks[kept++] = tasks[i];
+            else
+                pool.free(tasks[i]);
+        }
+        tasks.resize(kept);
+    }
+
+    bool idle() const { return tasks.empty(); }
+
+    // teardown: abandons whatever is still pending. stages own their
+    // cleanup via captures, so dropping them must stay safe
+    void clear()
+    {
+        for (size_t i = 0; i < tasks.size(); i++)
+            pool.free(tasks[i]);
+        tasks.clear();
+    }
+
+    std::vector<gpu_task_t*> tasks;
+    // one-shot operations come and go a few per frame at most; small
+    // blocks keep an idle scheduler at one page
+    object_pool_t<gpu_task_t, 16> pool;
+};
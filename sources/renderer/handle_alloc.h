@@ -0,0 +1,460 @@
+#ifndef __HANDLE_ALLOC_H__
+#define __HANDLE_ALLOC_H__
+
+#include <limits>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+typedef uint32_t handle_t;
+
+static const handle_t invalid_handle_t = UINT32_MAX;
+
+// packed handle layout: low 24 bits slot index, high 8 bits generation
+static const uint32_t handle_index_bits = 24;
+static const uint32_t handle_index_mask = (1u << handle_index_bits) - 1u;
+
+inline uint32_t handle_index(handle_t handle)
+{
+    return handle & handle_index_mask;
+}
+
+inline uint32_t handle_generation(handle_t handle)
+{
+    return handle >> handle_index_bits;
+}
+
+inline handle_t make_handle(uint32_t index, uint32_t generation)
+{
+    return (handle_t)((generation << handle_index_bits) | index);
+}
+
+// sparse/dense allocator with per-slot generations; a slot's generation is
+// bumped on free, so a stale handle fails valid() instead of silently
+// aliasing whatever reused the slot
+template <uint32_t max_handles_t>
+struct handle_alloc_t
+{
+    handle_alloc_t() :
+        _num_handles(0),
+        _max_handles(max_handles_t)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        _num_handles = 0;
+        _peak_handles = 0;
+        for (uint32_t i = 0, num = max_handles_t; i < num; i++)
+        {
+            _dense[i] = i;
+            _sparse[i] = i;
+            _generation[i] = 0;
+        }
+    }
+
+    handle_t alloc()
+    {
+        if (_num_handles < _max_handles)
+        {
+            uint32_t index = _num_handles;
+            _num_handles++;
+            if (_num_handles > _peak_handles)
+                _peak_handles = _num_handles;
+            uint32_t slot = _dense[index];
+            _sparse[slot] = index;
+
+            return make_handle(slot, _generation[slot]);
+        }
+        return invalid_handle_t;
+    }
+
+    bool valid(handle_t handle) const
+    {
+        if (handle == invalid_handle_t)
+            return false;
+
+        uint32_t slot = handle_index(handle);
+        if (slot >= max_handles_t)
+            return false;
+        if (_generation[slot] != handle_generation(handle))
+            return false;
+
+        return _sparse[slot] < _num_handles && _dense[_sparse[slot]] == slot;
+    }
+
+    void free(handle_t handle)
+    {
+        if (!valid(handle))
+            return;
+
+        uint32_t slot = handle_index(handle);
+        uint32_t top_index = _num_handles - 1;
+        uint32_t index = _sparse[slot];
+
+        // swap top element with removed one
+        uint32_t temp = _dense[top_index];
+        _dense[index] = temp;
+        _sparse[temp] = index;
+
+        // save removed one to reuse when alloc; keeping its sparse
+        // entry current means free slots stay addressable in O(1)
+        _dense[top_index] = slot;
+        _sparse[slot] = top_index;
+
+        // invalidate outstanding handles to this slot
+        _generation[slot] = (_generation[slot] + 1) & 0xffu;
+
+        _num_handles--;
+    }
+
+    // batch variants: one pass over the dense array instead of n calls.
+    // returns how many were allocated; the tail is set invalid when the
+    // table runs out mid-range
+    uint32_t alloc_range(uint32_t n, handle_t* out_handles)
+    {
+        uint32_t allocated = 0;
+        for (; allocated < n && _num_handles < _max_handles; allocated++)
+        {
+            uint32_t index = _num_handles++;
+            uint32_t slot = _dense[index];
+            _sparse[slot] = index;
+            out_handles[allocated] = make_handle(slot, _generation[slot]);
+        }
+        for (uint32_t i = allocated; i < n; i++)
+            out_handles[i] = invalid_handle_t;
+        if (_num_handles > _peak_handles)
+            _peak_handles = _num_handles;
+        return allocated;
+    }
+
+    void free_range(uint32_t n, const handle_t* handles)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            free(handles[i]);
+    }
+
+    // first-fit run of n slots with contiguous indices, for resources
+    // that want the indices themselves adjacent (texture-array layers).
+    // the scan is O(max_handles_t); meant for load time, not per frame
+    bool reserve_contiguous(uint32_t n, handle_t* out_handles)
+    {
+        if (n == 0 || n > max_handles_t - _num_handles)
+            return false;
+
+        for (uint32_t base = 0; base + n <= max_handles_t; base++)
+        {
+            uint32_t run = 0;
+            while (run < n && _sparse[base + run] >= _num_handles)
+                run++;
+            if (run < n)
+            {
+                base += run; // skip past the live slot that broke the run
+                continue;
+            }
+
+            for (uint32_t i = 0; i < n; i++)
+                out_handles[i] = alloc_slot(base + i);
+            return true;
+        }
+        return false;
+    }
+
+    // allocate one specific free slot by swapping its dense entry into
+    // the first free position
+    handle_t alloc_slot(uint32_t slot)
+    {
+        uint32_t index = _sparse[slot];
+        uint32_t first_free = _num_handles;
+        uint32_t other = _dense[first_free];
+
+        _dense[first_free] = slot;
+        _sparse[slot] = first_free;
+        _dense[index] = other;
+        _sparse[other] = index;
+
+        _num_handles++;
+        if (_num_handles > _peak_handles)
+            _peak_handles = _num_handles;
+        return make_handle(slot, _generation[slot]);
+    }
+
+    uint32_t _num_handles;
+    uint32_t _max_handles;
+    uint32_t _peak_handles; // high-water mark of live handles, for the memory dashboard
+
+    static_assert(max_handles_t > 0, "max_handle_t should be greater than 0");
+    static_assert(max_handles_t <= handle_index_mask + 1, "max_handle_t does not fit in the index bits");
+
+    uint32_t _dense[max_handles_t];     // hold slot values
+    uint32_t _sparse[max_handles_t];    // index cache
+    uint8_t _generation[max_handles_t]; // per-slot generation
+};
+
+// chunked-growth variant: the same sparse/dense scheme with the tables
+// split into fixed-size chunks allocated the first time the live count
+// reaches them, so capacity follows demand instead of a compile-time
+// worst case. every operation stays O(1) — slot lookups pay one extra
+// indirection through the chunk table — and a slot's storage never
+// moves once its chunk exists, so the id space keeps the pointer
+// stability of the fixed allocator. growth stops at the index-bit
+// ceiling, where alloc reports exhaustion the same way the fixed table
+// does
+template <uint32_t chunk_size_t>
+struct chunked_handle_alloc_t
+{
+    static_assert(chunk_size_t > 0 && (chunk_size_t & (chunk_size_t - 1)) == 0,
+        "chunk size must be a power of two");
+
+    struct chunk_t
+    {
+        uint32_t dense[chunk_size_t];
+        uint32_t sparse[chunk_size_t];
+        uint8_t generation[chunk_size_t];
+    };
+
+    chunked_handle_alloc_t() :
+        _num_handles(0),
+        _peak_handles(0)
+    {
+    }
+
+    ~chunked_handle_alloc_t()
+    {
+        reset();
+    }
+
+    // the chunk table owns raw allocations
+    chunked_handle_alloc_t(const chunked_handle_alloc_t&) = delete;
+    chunked_handle_alloc_t& operator=(const chunked_handle_alloc_t&) = delete;
+
+    void reset()
+    {
+        _num_handles = 0;
+        _peak_handles = 0;
+        for (chunk_t* chunk : _chunks)
+            delete chunk;
+        _chunks.clear();
+    }
+
+    uint32_t capacity() const
+    {
+        return (uint32_t)_chunks.size() * chunk_size_t;
+    }
+
+    handle_t alloc()
+    {
+        if (_num_handles == capacity() && !grow())
+            return invalid_handle_t;
+
+        uint32_t index = _num_handles;
+        _num_handles++;
+        if (_num_handles > _peak_handles)
+            _peak_handles = _num_handles;
+        uint32_t slot = dense(index);
+        sparse(slot) = index;
+
+        return make_handle(slot, generation(slot));
+    }
+
+    bool valid(handle_t handle) const
+    {
+        if (handle == invalid_handle_t)
+            return false;
+
+        uint32_t slot = handle_index(handle);
+        if (slot >= capacity())
+            return false;
+        if (generation(slot) != handle_generation(handle))
+            return false;
+
+        return sparse(slot) < _num_handles && dense(sparse(slot)) == slot;
+    }
+
+    void free(handle_t handle)
+    {
+        if (!valid(handle))
+            return;
+
+        uint32_t slot = handle_index(handle);
+        uint32_t top_index = _num_handles - 1;
+        uint32_t index = sparse(slot);
+
+        // swap top element with removed one
+        uint32_t temp = dense(top_index);
+        dense(index) = temp;
+        sparse(temp) = index;
+
+        // save removed one to reuse when alloc; keeping its sparse
+        // entry current means free slots stay addressable in O(1)
+        dense(top_index) = slot;
+        sparse(slot) = top_index;
+
+        // invalidate outstanding handles to this slot
+        generation(slot) = (generation(slot) + 1) & 0xffu;
+
+        _num_handles--;
+    }
+
+    uint32_t alloc_range(uint32_t n, handle_t* out_handles)
+    {
+        uint32_t allocated = 0;
+        for (; allocated < n; allocated++)
+        {
+            out_handles[allocated] = alloc();
+            if (out_handles[allocated] == invalid_handle_t)
+                break;
+        }
+        for (uint32_t i = allocated; i < n; i++)
+            out_handles[i] = invalid_handle_t;
+        return allocated;
+    }
+
+    void free_range(uint32_t n, const handle_t* handles)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            free(handles[i]);
+    }
+
+    // first-fit over the existing chunks; when no run fits, fresh
+    // chunks are entirely free, so the run lands at the old capacity
+    // boundary once enough of them exist
+    bool reserve_contiguous(uint32_t n, handle_t* out_handles)
+    {
+        if (n == 0 || n > handle_index_mask + 1 - _num_handles)
+            return false;
+
+        for (uint32_t base = 0; capacity() >= n && base + n <= capacity(); base++)
+        {
+            uint32_t run = 0;
+            while (run < n && sparse(base + run) >= _num_handles)
+                run++;
+            if (run < n)
+            {
+                base += run; // skip past the live slot that broke the run
+                continue;
+            }
+
+            for (uint32_t i = 0; i < n; i++)
+                out_handles[i] = alloc_slot(base + i);
+            return true;
+        }
+
+        uint32_t base = capacity();
+        while (capacity() < base + n)
+        {
+            if (!grow())
+                return false;
+        }
+        for (uint32_t i = 0; i < n; i++)
+            out_handles[i] = alloc_slot(base + i);
+        return true;
+    }
+
+    handle_t alloc_slot(uint32_t slot)
+    {
+        uint32_t index = sparse(slot);
+        uint32_t first_free = _num_handles;
+        uint32_t other = dense(first_free);
+
+        dense(first_free) = slot;
+        sparse(slot) = first_free;
+        dense(index) = other;
+        sparse(other) = index;
+
+        _num_handles++;
+        if (_num_handles > _peak_handles)
+            _peak_handles = _num_handles;
+        return make_handle(slot, generation(slot));
+    }
+
+    // a fresh chunk's slots are identity-mapped free entries past the
+    // live range, which is exactly what the sparse/dense invariant
+    // expects of untouched capacity
+    bool grow()
+    {
+        uint32_t base = capacity();
+        if (base + chunk_size_t > handle_index_mask + 1)
+            return false;
+
+        chunk_t* chunk = new chunk_t;
+        for (uint32_t i = 0; i < chunk_size_t; i++)
+        {
+            chunk->dense[i] = base + i;
+            chunk->sparse[i] = base + i;
+            chunk->generation[i] = 0;
+        }
+        _chunks.push_back(chunk);
+        return true;
+    }
+
+    uint32_t& dense(uint32_t i) { return _chunks[i / chunk_size_t]->dense[i & (chunk_size_t - 1)]; }
+    uint32_t& sparse(uint32_t i) { return _chunks[i / chunk_size_t]->sparse[i & (chunk_size_t - 1)]; }
+    uint8_t& generation(uint32_t i) { return _chunks[i / chunk_size_t]->generation[i & (chunk_size_t - 1)]; }
+    uint32_t dense(uint32_t i) const { return _chunks[i / chunk_size_t]->dense[i & (chunk_size_t - 1)]; }
+    uint32_t sparse(uint32_t i) const { return _chunks[i / chunk_size_t]->sparse[i & (chunk_size_t - 1)]; }
+    uint8_t generation(uint32_t i) const { return _chunks[i / chunk_size_t]->generation[i & (chunk_size_t - 1)]; }
+
+    uint32_t _num_handles;
+    uint32_t _peak_handles; // high-water mark of live handles, for the memory dashboard
+    std::vector<chunk_t*> _chunks;
+};
+
+// shared variant for worker threads reserving handles off the render
+// thread (async loaders and friends): the same sparse/dense allocator
+// behind one mutex. free() swaps the dense top, so a lock-free version
+// would have to publish two slots atomically — not worth it when the
+// critical section is a handful of array writes. kept separate so the
+// render thread's allocator stays uncontended
+template <uint32_t max_handles_t>
+struct shared_handle_alloc_t
+{
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _base.reset();
+    }
+
+    handle_t alloc()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _base.alloc();
+    }
+
+    bool valid(handle_t handle) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _base.valid(handle);
+    }
+
+    void free(handle_t handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _base.free(handle);
+    }
+
+    // batches pay the lock once, which is most of the point here
+    uint32_t alloc_range(uint32_t n, handle_t* out_handles)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _base.alloc_range(n, out_handles);
+    }
+
+    void free_range(uint32_t n, const handle_t* handles)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _base.free_range(n, handles);
+    }
+
+    bool reserve_contiguous(uint32_t n, handle_t* out_handles)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _base.reserve_contiguous(n, out_handles);
+    }
+
+    mutable std::mutex _mutex;
+    handle_alloc_t<max_handles_t> _base;
+};
+
+#endif // __HANDLE_ALLOC_H__
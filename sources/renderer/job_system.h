@@ -0,0 +1,326 @@
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "handle_alloc.h"
+
+// small shared job system: a fixed pool of job slots, one work-stealing
+// deque per worker, and per-job dependency counters so graphs like
+// decode-fan-out -> submit express directly. workers start lazily on
+// the first enqueue, waiting threads help execute instead of blocking,
+// and the slot pool recycles as a ring with generations so stale
+// handles read as finished instead of aliasing a reused slot
+
+typedef handle_t job_handle_t;
+
+// tiny test-and-set lock; every critical section here is a few array
+// writes, the same trade shared_handle_alloc_t makes against a
+// lock-free scheme
+struct job_lock_t
+{
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    void lock() { while (flag.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag.clear(std::memory_order_release); }
+};
+
+struct job_system_t
+{
+    static const uint32_t max_jobs = 1024;
+    static const int max_workers = 15;
+    static const int32_t max_dependents = 4;
+
+    struct job_t
+    {
+        void (*function)(void*) = nullptr;
+        void* data = nullptr;
+
+        // outstanding prerequisites plus one submit guard; the job
+        // queues when this reaches zero
+        std::atomic<int32_t> pending { 0 };
+        std::atomic<bool> done { true };
+        std::atomic<uint32_t> generation { 0 };
+
+        // slots to release when this one finishes, guarded so a
+        // finishing job can't race a depends() registration
+        job_lock_t guard;
+        uint32_t dependents[max_dependents];
+        int32_t dependent_count = 0;
+    };
+
+    // spin-locked ring deque: the owner pushes and pops at the bottom
+    // (lifo keeps its caches warm), thieves steal the oldest work from
+    // the top
+    struct deque_t
+    {
+        static const uint32_t capacity = 256;
+
+        uint32_t entries[capacity];
+        uint32_t top = 0;       // thieves take here
+        uint32_t bottom = 0;    // the owner works here
+        job_lock_t guard;
+
+        bool push(uint32_t value)
+        {
+            guard.lock();
+            bool fits = bottom - top < capacity;
+            if (fits)
+                entries[bottom++ % capacity] = value;
+            guard.unlock();
+            return fits;
+        }
+
+        bool pop(uint32_t* out)
+        {
+            guard.lock();
+            bool any = bottom != top;
+            if (any)
+                *out = entries[--bottom % capacity];
+            guard.unlock();
+            return any;
+        }
+
+        bool steal(uint32_t* out)
+        {
+            guard.lock();
+            bool any = bottom != top;
+            if (any)
+                *out = entries[top++ % capacity];
+            guard.unlock();
+            return any;
+        }
+    };
+
+    job_handle_t create(void (*function)(void*), void* data)
+    {
+        uint32_t slot = cursor.fetch_add(1, std::memory_order_relaxed) % max_jobs;
+        job_t& job = jobs[slot];
+
+        // the ring wrapped onto a job that never finished; the pool is
+        // sized for frames, not for a backlog
+        assert(job.done.load(std::memory_order_acquire));
+
+        job.function = function;
+        job.data = data;
+        job.dependent_count = 0;
+        job.pending.store(1, std::memory_order_relaxed); // the submit guard
+        job.done.store(false, std::memory_order_relaxed);
+
+        uint32_t generation = job.generation.fetch_add(1, std::memory_order_release) + 1;
+        return make_handle(slot, generation & 0xffu);
+    }
+
+    // register before submitting the dependent; a prerequisite that
+    // already finished (or was recycled) just doesn't count
+    void depends(job_handle_t handle, job_handle_t prerequisite)
+    {
+        job_t& before = jobs[handle_index(prerequisite)];
+
+        before.guard.lock();
+        bool live = (before.generation.load(std::memory_order_relaxed) & 0xffu) == handle_generation(prerequisite)
+            && !before.done.load(std::memory_order_relaxed);
+        if (live)
+        {
+            assert(before.dependent_count < max_dependents);
+            before.dependents[before.dependent_count++] = handle_index(handle);
+            jobs[handle_index(handle)].pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        before.guard.unlock();
+    }
+
+    // drop the submit guard; the job queues once the last outstanding
+    // prerequisite (or this call) brings pending to zero
+    void submit(job_handle_t handle)
+    {
+        release(handle_index(handle));
+    }
+
+    bool finished(job_handle_t handle) const
+    {
+        const job_t& job = jobs[handle_index(handle)];
+        if ((job.generation.load(std::memory_order_acquire) & 0xffu) != handle_generation(handle))
+            return true; // the slot moved on; the job it held is long done
+        return job.done.load(std::memory_order_acquire);
+    }
+
+    // help execute queued jobs until the handle resolves, so a waiting
+    // thread adds throughput instead of parking
+    void wait(job_handle_t handle)
+    {
+        while (!finished(handle))
+        {
+            uint32_t slot;
+            if (take_any(&slot))
+                execute(slot);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    int worker_count() const
+    {
+        return (int)workers.size();
+    }
+
+    ~job_system_t()
+    {
+        if (workers.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(park_mutex);
+            stopping = true;
+        }
+        park_condition.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+private:
+
+    void release(uint32_t slot)
+    {
+        if (jobs[slot].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            enqueue(slot);
+    }
+
+    void enqueue(uint32_t slot)
+    {
+        if (!started.load(std::memory_order_acquire))
+            start();
+
+        uint32_t target = push_cursor.fetch_add(1, std::memory_order_relaxed) % (uint32_t)workers.size();
+        if (!deques[target].push(slot))
+        {
+            // a full deque means the frame outran the queues; running
+            // inline is slower but never wrong
+            execute(slot);
+            return;
+        }
+
+        queued.fetch_add(1, std::memory_order_release);
+
+        // the empty critical section orders the increment against the
+        // predicate check, so the wakeup can't fall between them
+        { std::lock_guard<std::mutex> lock(park_mutex); }
+        park_condition.notify_one();
+    }
+
+    void execute(uint32_t slot)
+    {
+        job_t& job = jobs[slot];
+        job.function(job.data);
+
+        uint32_t dependents[max_dependents];
+        int32_t count;
+
+        job.guard.lock();
+        job.done.store(true, std::memory_order_release);
+        count = job.dependent_count;
+        memcpy(dependents, job.dependents, sizeof(uint32_t) * count);
+        job.guard.unlock();
+
+        for (int32_t i = 0; i < count; i++)
+            release(dependents[i]);
+    }
+
+    bool take(int self, uint32_t* out)
+    {
+        if (deques[self].pop(out) || take_stolen(self, out))
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool take_any(uint32_t* out)
+    {
+        if (!started.load(std::memory_order_acquire))
+            return false;
+        if (take_stolen(-1, out))
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool take_stolen(int self, uint32_t* out)
+    {
+        for (int other = 0; other < (int)workers.size(); other++)
+        {
+            if (other == self)
+                continue;
+            if (deques[other].steal(out))
+                return true;
+        }
+        return false;
+    }
+
+    void loop(int self)
+    {
+        while (true)
+        {
+            uint32_t slot;
+            if (take(self, &slot))
+            {
+                execute(slot);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(park_mutex);
+            park_condition.wait(lock, [this]{
+                return queued.load(std::memory_order_acquire) > 0 || stopping;
+            });
+            if (stopping && queued.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(park_mutex);
+        if (started.load(std::memory_order_relaxed) || stopping)
+            return;
+
+        // the submitting thread keeps working too, so one worker per
+        // remaining hardware thread
+        int count = (int)std::thread::hardware_concurrency() - 1;
+        count = std::min(std::max(count, 1), max_workers);
+
+        for (int w = 0; w < count; w++)
+            workers.emplace_back([this, w]{ loop(w); });
+
+        started.store(true, std::memory_order_release);
+    }
+
+    job_t jobs[max_jobs];
+
+    // fixed storage: deque_t holds an atomic flag and can't live in a
+    // growing container anyway
+    deque_t deques[max_workers];
+    std::vector<std::thread> workers;
+
+    std::atomic<uint32_t> cursor { 0 };
+    std::atomic<uint32_t> push_cursor { 0 };
+    std::atomic<int32_t> queued { 0 };
+    std::atomic<bool> started { false };
+
+    std::mutex park_mutex;
+    std::condition_variable park_condition;
+    bool stopping = false;
+};
+
+namespace {
+    job_system_t job_system;
+}
+
+#endif // __JOB_SYSTEM_H__
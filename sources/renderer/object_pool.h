@@ -0,0 +1,120 @@
+#pragma once
+
+// intrusive object pool for small per-operation records — async loads,
+// readbacks, multi-frame tasks — that need stable addresses and must not
+// put new/delete back in the frame loop. the freelist is threaded through
+// the dead records' own storage (handle_alloc_t keeps its freelist in a
+// side table because it hands out indices; here the record IS the slot,
+// so the next pointer lives where the record will), which makes alloc and
+// free one pointer swap each. growth appends fixed-size blocks that are
+// never moved or recycled, so a pointer handed out stays valid until it
+// is freed regardless of what the pool does afterwards.
+//
+// every pool registers itself on an intrusive list at construction, the
+// same shape as the tuning-parameter registry, so the memory dashboard
+// can walk live/capacity for all of them without knowing who owns what.
+//
+// standalone on purpose: no gl types, no renderer types
+
+#include <new>
+#include <stdint.h>
+#include <vector>
+
+// occupancy snapshot; one per pool, chained through a function-local
+// head so inclusion order cannot break registration
+struct object_pool_stats_t
+{
+    static object_pool_stats_t*& head()
+    {
+        static object_pool_stats_t* first = nullptr;
+        return first;
+    }
+
+    explicit object_pool_stats_t(const char* pool_name) :
+        name(pool_name)
+    {
+        next = head();
+        head() = this;
+    }
+
+    const char* name;
+    uint32_t live = 0;
+    uint32_t capacity = 0;
+    uint32_t peak = 0;
+    object_pool_stats_t* next;
+};
+
+template <typename record_t, uint32_t block_records_t = 64>
+struct object_pool_t
+{
+    explicit object_pool_t(const char* name) :
+        stats(name)
+    {
+    }
+
+    // pools sit in long-lived owners; the records they still hold are
+    // torn down by the owner before this runs, so only raw storage is
+    // released here. a nonzero live count at this point is a leak, but
+    // the pool cannot name the leaker — the exit report can
+    ~object_pool_t()
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
+            ::operator delete(blocks[i]);
+    }
+
+    object_pool_t(const object_pool_t&) = delete;
+    object_pool_t& operator=(const object_pool_t&) = delete;
+
+    record_t* alloc()
+    {
+        if (free_head == nullptr)
+            grow();
+        slot_t* slot = free_head;
+        free_head = slot->next;
+        stats.live++;
+        if (stats.live > stats.peak)
+            stats.peak = stats.live;
+        return new (slot) record_t();
+    }
+
+    void free(record_t* record)
+    {
+        record->~record_t();
+        slot_t* slot = reinterpret_cast<slot_t*>(record);
+        slot->next = free_head;
+        free_head = slot;
+        stats.live--;
+    }
+
+private:
+    // a dead record's storage doubles as its freelist link
+    union slot_t
+    {
+        slot_t* next;
+        // storage for record_t; the union sizes and aligns the slot
+        alignas(record_t) unsigned char storage[sizeof(record_t)];
+    };
+
+    static_assert(alignof(record_t) <= alignof(std::max_align_t),
+        "over-aligned records need aligned block storage this pool does not provide");
+
+    void grow()
+    {
+        slot_t* block = static_cast<slot_t*>(::operator new(sizeof(slot_t) * block_records_t));
+        blocks.push_back(block);
+        // thread the new block onto the freelist back to front so
+        // allocation walks it in address order
+        for (uint32_t i = block_records_t; i > 0; i--)
+        {
+            block[i - 1].next = free_head;
+            free_head = &block[i - 1];
+        }
+        stats.capacity += block_records_t;
+    }
+
+    slot_t* free_head = nullptr;
+    std::vector<slot_t*> blocks;
+
+public:
+    object_pool_stats_t stats;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// precompiled-header set for the samples: the heavy external includes
+// that dominate each main.cpp's parse time and never change between
+// perf experiments. project headers stay out on purpose - they are the
+// files being iterated on, and a pch rebuild would cost more than it
+// saves. consumed through uno_fast_builds() in sources/CMakeLists.txt,
+// so builds on an older cmake (or with SUPPORT_FAST_BUILDS off) simply
+// compile everything the ordinary way
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <imgui.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
@@ -0,0 +1,123 @@
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+// low-overhead timestamp source shared by all the instrumentation. a
+// chrono now() is a vsyscall at best and a full QueryPerformanceCounter
+// on windows; with the profiler zones stamping dozens of times per
+// frame that overhead starts perturbing what it measures. rdtsc is a
+// handful of cycles, so the clock reads the tsc directly once it has
+// been calibrated against the os clock at startup, and falls back to
+// chrono on cpus without an invariant tsc (or off x86 entirely)
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_CLOCK_HAS_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#else
+#define CPU_CLOCK_HAS_TSC 0
+#endif
+
+struct cpu_clock_t
+{
+    static int64_t chrono_us()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+#if CPU_CLOCK_HAS_TSC
+    static uint64_t read_tsc()
+    {
+        return __rdtsc();
+    }
+
+    // cpuid 0x80000007 edx bit 8: the tsc ticks at a constant rate
+    // across p-states and deep sleep; anything older drifts against
+    // wall time and is useless as a clock
+    static bool invariant_tsc()
+    {
+#if defined(_MSC_VER)
+        int regs[4] = {};
+        __cpuid(regs, 0x80000000);
+        if ((unsigned int)regs[0] < 0x80000007u)
+            return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) == 0)
+            return false;
+        return (edx & (1u << 8)) != 0;
+#endif
+    }
+#endif
+
+    // first half of the calibration: stamp a tsc/os-clock pair at the
+    // top of main. no interval has passed yet, so reads keep going
+    // through chrono until calibrate()
+    void setup()
+    {
+#if CPU_CLOCK_HAS_TSC
+        if (!invariant_tsc())
+            return;
+        setup_tick = read_tsc();
+        setup_us = chrono_us();
+        armed = true;
+#endif
+    }
+
+    // second half, anywhere a few milliseconds later — startup itself
+    // is the interval: derive the tick rate, anchor the origin and
+    // switch reads over to the tsc
+    void calibrate()
+    {
+#if CPU_CLOCK_HAS_TSC
+        if (!armed || use_tsc)
+            return;
+
+        uint64_t tick = read_tsc();
+        int64_t us = chrono_us();
+        if (us - setup_us < 1000 || tick <= setup_tick)
+            return; // interval too short to trust; stay on chrono
+
+        us_per_tick = (double)(us - setup_us) / (double)(tick - setup_tick);
+        tick_origin = tick;
+        us_origin = us;
+        use_tsc = true;
+#endif
+    }
+
+    // epoch-comparable microseconds, so tsc stamps line up with the gpu
+    // timestamp calibration and anything taken before the switch-over
+    int64_t now_us() const
+    {
+#if CPU_CLOCK_HAS_TSC
+        if (use_tsc)
+            return us_origin + (int64_t)((read_tsc() - tick_origin) * us_per_tick);
+#endif
+        return chrono_us();
+    }
+
+    bool use_tsc = false;
+#if CPU_CLOCK_HAS_TSC
+    bool armed = false;
+    uint64_t setup_tick = 0;
+    int64_t setup_us = 0;
+    uint64_t tick_origin = 0;
+    int64_t us_origin = 0;
+    double us_per_tick = 0.0;
+#endif
+};
+
+namespace {
+    cpu_clock_t cpu_clock;
+}
+
+#endif // __TIMER_H__
@@ -0,0 +1,420 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+// asynchronous trace sink shared by the samples. trace() formats into a
+// stack buffer and pushes the record onto a per-thread SPSC ring; a
+// background thread drains every ring into the platform logger. the
+// hot-path cost is one vsnprintf plus a bounded copy and two atomics —
+// OutputDebugStringA takes a process-wide lock and is catastrophically
+// slow under a debugger, and the GL debug callback can fire per draw,
+// so the platform call must never run on a recording thread
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if _WIN32
+extern "C" __declspec(dllimport) void __stdcall OutputDebugStringA(const char* _str);
+#else
+#   if defined(__OBJC__)
+#       import <Foundation/NSObjCRuntime.h>
+#   else
+#       include <CoreFoundation/CFString.h>
+        extern "C" void NSLog(CFStringRef _format, ...);
+#   endif
+#endif
+
+// the synchronous platform call; only the drain thread comes here
+void debug_output(const char* message)
+{
+#if _WIN32
+    OutputDebugStringA(message);
+#else
+#   if defined(__OBJC__)
+    NSLog(@"%s", message);
+#   else
+    NSLog(CFSTR("%s"), message);
+#   endif
+#endif
+}
+
+// log levels; TRACE_LEVEL is the compile-time threshold, and the level
+// check in the macros below folds away on the constant so a disabled
+// level costs nothing at all
+enum trace_level_t
+{
+    trace_level_error = 0,
+    trace_level_warn,
+    trace_level_info,
+    trace_level_debug,
+};
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL trace_level_info
+#endif
+
+// single-producer single-consumer ring of records; producer is the
+// owning thread, consumer is the drain thread, no locks anywhere.
+// records are either preformatted text or a deferred format: a literal
+// pointer plus typed argument captures, expanded on the drain thread so
+// the hot path never pays for formatting
+struct trace_ring_t
+{
+    static const uint32_t ring_size = 64;        // records; power of two
+    static const uint32_t record_length = 1024;  // text bytes, truncating
+    static const uint32_t max_args = 8;
+
+    enum arg_kind_t : uint8_t
+    {
+        arg_int = 0,    // anything integral, widened to long long
+        arg_double,     // floats promote like varargs would
+        arg_string,     // copied into text; value is the offset
+        arg_pointer,
+    };
+
+    struct record_t
+    {
+        const char* format;     // nullptr: text is a preformatted line
+        uint32_t arg_count;
+        uint8_t kinds[max_args];
+        uint64_t values[max_args];
+        char text[record_length];
+    };
+
+    // producer side only: preformatted line
+    bool push(const char* text)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= ring_size)
+            return false; // full: drop rather than block the hot path
+
+        record_t& record = records[h & (ring_size - 1)];
+        record.format = nullptr;
+        record.arg_count = 0;
+        strncpy(record.text, text, record_length - 1);
+        record.text[record_length - 1] = '\0';
+
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer side only: deferred format. the format must be a string
+    // literal — the drain thread reads it after this call returns
+    template <typename... args_t>
+    bool push_format(const char* format, args_t... args)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= ring_size)
+            return false;
+
+        record_t& record = records[h & (ring_size - 1)];
+        record.format = format;
+        record.arg_count = 0;
+        size_t cursor = 0;
+        capture_args(record, cursor, args...);
+
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side only
+    bool pop(record_t& out)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+
+        out = records[t & (ring_size - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // typed capture: every argument collapses to one of four kinds the
+    // drain thread knows how to feed back into snprintf. one template,
+    // dispatched with if-constexpr - every branch but the taken one
+    // drops out at instantiation, so a capture compiles to exactly the
+    // two stores it needs
+    template <typename arg_t>
+    static void capture_one(record_t& record, size_t& cursor, arg_t value)
+    {
+        if constexpr (std::is_same<arg_t, const char*>::value || std::is_same<arg_t, char*>::value)
+        {
+            capture_one(record, cursor, std::string_view(value != nullptr ? value : "(null)"));
+        }
+        else if constexpr (std::is_integral<arg_t>::value || std::is_enum<arg_t>::value)
+        {
+            record.kinds[record.arg_count] = arg_int;
+            record.values[record.arg_count++] = (uint64_t)(long long)value;
+        }
+        else if constexpr (std::is_floating_point<arg_t>::value)
+        {
+            double widened = (double)value;
+            record.kinds[record.arg_count] = arg_double;
+            memcpy(&record.values[record.arg_count++], &widened, sizeof(widened));
+        }
+        else
+        {
+            static_assert(std::is_pointer<arg_t>::value, "unsupported trace argument type");
+            record.kinds[record.arg_count] = arg_pointer;
+            record.values[record.arg_count++] = (uint64_t)(uintptr_t)value;
+        }
+    }
+
+    static void capture_one(record_t& record, size_t& cursor, std::string_view value)
+    {
+        // strings may point at scratch that dies before the drain runs,
+        // so the bytes ride in the record. the view carries its length,
+        // so no strlen on the hot path
+        record.kinds[record.arg_count] = arg_string;
+        record.values[record.arg_count++] = (uint64_t)cursor;
+
+        size_t room = record_length - cursor;
+        size_t length = value.size();
+        if (length >= room)
+            length = room ? room - 1 : 0;
+        memcpy(record.text + cursor, value.data(), length);
+        record.text[cursor + length] = '\0';
+        cursor += length + 1;
+    }
+
+    static void capture_args(record_t&, size_t&) {}
+
+    template <typename first_t, typename... rest_t>
+    static void capture_args(record_t& record, size_t& cursor, first_t first, rest_t... rest)
+    {
+        if (record.arg_count < max_args)
+            capture_one(record, cursor, first);
+        capture_args(record, cursor, rest...);
+    }
+
+    std::atomic<uint32_t> head{ 0 };
+    std::atomic<uint32_t> tail{ 0 };
+    std::atomic<uint32_t> dropped{ 0 };
+    record_t records[ring_size];
+};
+
+// expand a deferred record on the drain thread. the format splits at
+// each conversion; integer conversions are renormalized to the captured
+// long long width, so callers write plain %d/%u/%x against any integer
+// type. '*' widths and %n are not supported
+inline void format_trace_record(const trace_ring_t::record_t& record, char* out, size_t out_size)
+{
+    if (record.format == nullptr)
+    {
+        strncpy(out, record.text, out_size - 1);
+        out[out_size - 1] = '\0';
+        return;
+    }
+
+    const char* f = record.format;
+    size_t written = 0;
+    uint32_t arg = 0;
+
+    while (*f != '\0' && written + 1 < out_size)
+    {
+        if (*f != '%')
+        {
+            out[written++] = *f++;
+            continue;
+        }
+
+        f++;
+        if (*f == '%')
+        {
+            out[written++] = '%';
+            f++;
+            continue;
+        }
+
+        char spec[32];
+        size_t spec_len = 0;
+        spec[spec_len++] = '%';
+        while (*f != '\0' && spec_len < sizeof(spec) - 4 && strchr("-+ #0123456789.", *f) != nullptr)
+            spec[spec_len++] = *f++;
+        while (*f == 'h' || *f == 'l' || *f == 'L' || *f == 'z' || *f == 't' || *f == 'j')
+            f++; // the capture already fixed the width
+        char conv = *f != '\0' ? *f++ : '\0';
+
+        uint64_t value = (arg < record.arg_count) ? record.values[arg] : 0;
+        uint8_t kind = (arg < record.arg_count) ? record.kinds[arg] : (uint8_t)trace_ring_t::arg_int;
+        arg++;
+
+        int n = 0;
+        switch (conv)
+        {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = conv;
+            spec[spec_len] = '\0';
+            n = snprintf(out + written, out_size - written, spec, (long long)value);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+        {
+            double d = 0.0;
+            if (kind == trace_ring_t::arg_double)
+                memcpy(&d, &value, sizeof(d));
+            else
+                d = (double)(long long)value;
+            spec[spec_len++] = conv;
+            spec[spec_len] = '\0';
+            n = snprintf(out + written, out_size - written, spec, d);
+            break;
+        }
+        case 'c':
+            spec[spec_len++] = 'c';
+            spec[spec_len] = '\0';
+            n = snprintf(out + written, out_size - written, spec, (int)value);
+            break;
+        case 's':
+            spec[spec_len++] = 's';
+            spec[spec_len] = '\0';
+            n = snprintf(out + written, out_size - written, spec,
+                kind == trace_ring_t::arg_string ? record.text + value : "(null)");
+            break;
+        case 'p':
+            spec[spec_len++] = 'p';
+            spec[spec_len] = '\0';
+            n = snprintf(out + written, out_size - written, spec, (void*)(uintptr_t)value);
+            break;
+        default:
+            break; // unknown conversion: dropped
+        }
+
+        if (n > 0)
+            written = (written + n < out_size) ? written + n : out_size - 1;
+    }
+
+    out[written] = '\0';
+}
+
+// owns the per-thread rings and the drain thread; the thread starts
+// lazily with the first record, like the texture loader's worker, so
+// runs that never trace pay nothing
+struct trace_sink_t
+{
+    trace_ring_t* ring_for_thread()
+    {
+        thread_local trace_ring_t* ring = nullptr;
+        if (ring == nullptr)
+        {
+            ring = new trace_ring_t();
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(ring);
+            if (!worker.joinable())
+                worker = std::thread([this]() { loop(); });
+        }
+        return ring;
+    }
+
+    void write(const char* text)
+    {
+        trace_ring_t* ring = ring_for_thread();
+        if (!ring->push(text))
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // deferred entry used by the level macros; formatting happens on the
+    // drain thread. format must be a string literal
+    template <typename... args_t>
+    void write_format(const char* format, args_t... args)
+    {
+        trace_ring_t* ring = ring_for_thread();
+        if (!ring->push_format(format, args...))
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // the mutex only guards ring registration; the pops are lock-free
+    void drain()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (trace_ring_t* ring : rings)
+        {
+            trace_ring_t::record_t record;
+            char line[trace_ring_t::record_length];
+            while (ring->pop(record))
+            {
+                format_trace_record(record, line, sizeof(line));
+                debug_output(line);
+            }
+
+            uint32_t lost = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (lost != 0)
+            {
+                char note[64];
+                snprintf(note, sizeof(note), "trace: %u records dropped\n", lost);
+                debug_output(note);
+            }
+        }
+    }
+
+    void loop()
+    {
+        while (running.load(std::memory_order_acquire))
+        {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        drain(); // final sweep so shutdown messages still land
+    }
+
+    ~trace_sink_t()
+    {
+        if (worker.joinable())
+        {
+            running.store(false, std::memory_order_release);
+            worker.join();
+        }
+        // rings are deliberately leaked: a detached thread may still
+        // hold its pointer, and the process is exiting anyway
+    }
+
+    std::atomic<bool> running{ true };
+    std::mutex mutex;
+    std::vector<trace_ring_t*> rings;
+    std::thread worker;
+};
+
+namespace {
+    trace_sink_t trace_sink;
+}
+
+void trace(const char* format, ...)
+{
+    const int kLength = 1024;
+    char buffer[kLength + 1] = {0,};
+
+    va_list argList;
+    va_start(argList, format);
+    int len = vsnprintf(buffer, kLength, format, argList);
+    va_end(argList);
+    if (len > kLength)
+        len = kLength;
+    buffer[len] = '\0';
+
+    trace_sink.write(buffer);
+}
+
+// leveled entry points. the threshold comparison is a compile-time
+// constant, so a disabled level's call (and its argument evaluation)
+// is eliminated outright; an enabled one captures typed arguments and
+// defers the formatting to the drain thread
+#define TRACE_AT_LEVEL(level, ...) \
+    do { if ((level) <= TRACE_LEVEL) trace_sink.write_format(__VA_ARGS__); } while (0)
+
+#define trace_error(...) TRACE_AT_LEVEL(trace_level_error, __VA_ARGS__)
+#define trace_warn(...)  TRACE_AT_LEVEL(trace_level_warn, __VA_ARGS__)
+#define trace_info(...)  TRACE_AT_LEVEL(trace_level_info, __VA_ARGS__)
+#define trace_debug(...) TRACE_AT_LEVEL(trace_level_debug, __VA_ARGS__)
+
+#endif // __TRACE_H__
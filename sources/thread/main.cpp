@@ -10,25 +10,110 @@
 #include <chrono>
 #include <vector>
 #include <thread>
-#include <queue>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <new>
 
+#if _WIN32
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
 #include <dwmapi.h>
 
-#include <Wingdi.h>
-#include <GL/gl.h>
-#include <GL/glext.h>
-#include <GL/wglext.h>
-
-#pragma comment(lib, "opengl32.lib")
 #pragma comment(lib, "dwmapi.lib")
+#pragma comment(lib, "synchronization.lib") // WaitOnAddress / WakeByAddressSingle
+#else
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#endif
 
+#include <atomic>
 #include <condition_variable>
 
+// counting semaphore with an atomic fast path: an uncontended set/wait
+// pair is two atomic ops, no lock and no syscall. waiters spin a
+// bounded number of iterations — frame handoff usually lands within a
+// few thousand — before parking on the count with WaitOnAddress, and
+// the count means back-to-back posts never coalesce the way the old
+// binary flag did. outside windows the park falls back to mutex plus
+// condition variable; the spin phase still catches the common handoff,
+// so only the rare park pays the lock
 class semaphore_t
 {
+private:
+    std::atomic<long> count_ { 0 };
+    std::atomic<long> waiters_ { 0 };
+
+    // spinning starves the poster when there is no second hardware
+    // thread to post from, so the spin phase only runs when another
+    // core can make progress in parallel
+    static int spin_limit() {
+        static const int limit = std::thread::hardware_concurrency() > 1 ? 4000 : 0;
+        return limit;
+    }
+
+    bool try_acquire() {
+        long count = count_.load(std::memory_order_relaxed);
+        return count > 0 && count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire);
+    }
+
+public:
+    void set() {
+        count_.fetch_add(1, std::memory_order_release);
+        // the wake syscall only happens when someone actually parked
+        if (waiters_.load(std::memory_order_acquire) > 0)
+        {
+#if _WIN32
+            WakeByAddressSingle(&count_);
+#else
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            park_cv_.notify_one();
+#endif
+        }
+    }
+
+    void wait() {
+        for (int spin = 0, limit = spin_limit(); spin < limit; spin++)
+        {
+            if (try_acquire())
+                return;
+#if _WIN32
+            YieldProcessor();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+#if _WIN32
+        while (!try_acquire())
+        {
+            long expected = 0;
+            WaitOnAddress(&count_, &expected, sizeof(long), INFINITE);
+        }
+#else
+        {
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            park_cv_.wait(lock, [this] { return try_acquire(); });
+        }
+#endif
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+#if !_WIN32
+private:
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+#endif
+};
+
+// the previous implementation, kept so the startup micro-benchmark can
+// put a number on the difference
+class mutex_semaphore_t
+{
 private:
     std::mutex mutex_;
     std::condition_variable condition_;
@@ -48,47 +133,194 @@ public:
     }
 };
 
-#if _WIN32
-extern "C" __declspec(dllimport) void __stdcall OutputDebugStringA(const char* _str);
-#else
-#   if defined(__OBJC__)
-#       import <Foundation/NSObjCRuntime.h>
-#   else
-#       include <CoreFoundation/CFString.h>
-        extern "C" void NSLog(CFStringRef _format, ...);
-#   endif
+#include "trace.h"
+#include "fullscreen_pass.h"
+#include "gl_program.h"
+#include "gl_context.h"
+
+#if !_WIN32
+// neutral tokens for the preset table; only the windows path maps them
+// to scheduler levels
+#define THREAD_PRIORITY_HIGHEST 2
+#define THREAD_PRIORITY_NORMAL 0
+#define THREAD_PRIORITY_BELOW_NORMAL (-1)
 #endif
 
-void debug_output(const char* message);
-void trace(const char* format, ...);
+// thread start configuration: affinity mask, priority and a
+// profiler-visible name. on hybrid parts the scheduler happily
+// migrates the render thread onto an e-core mid-session and frame
+// time doubles; pinning plus priority keeps it parked
+struct thread_config_t
+{
+    uint64_t affinity_mask; // 0 leaves placement to the scheduler
+    int priority;           // THREAD_PRIORITY_* level
+    const char* name;       // shows up in debuggers and profilers
+};
+
+#if _WIN32
+// SetThreadDescription only exists from windows 10 1607; resolved at
+// runtime so older installs just skip the naming
+typedef HRESULT (WINAPI *set_thread_description_t)(HANDLE, PCWSTR);
+#endif
 
-void trace(const char* format, ...)
+void apply_thread_config(const thread_config_t& config)
 {
-    const int kLength = 1024;
-    char buffer[kLength + 1] = {0,};
-    
-    va_list argList;
-    va_start(argList, format);
-    int len = vsnprintf(buffer, kLength, format, argList);
-    va_end(argList);
-    if (len > kLength)
-        len = kLength;
-    buffer[len] = '\0';
+#if _WIN32
+    HANDLE thread = GetCurrentThread();
+
+    if (config.affinity_mask != 0)
+        SetThreadAffinityMask(thread, (DWORD_PTR)config.affinity_mask);
+
+    SetThreadPriority(thread, config.priority);
 
-    debug_output(buffer);
+    if (config.name != nullptr)
+    {
+        static set_thread_description_t set_thread_description =
+            (set_thread_description_t)GetProcAddress(GetModuleHandleA("kernel32.dll"), "SetThreadDescription");
+        if (set_thread_description != nullptr)
+        {
+            wchar_t wide[64];
+            swprintf(wide, 64, L"%hs", config.name);
+            set_thread_description(thread, wide);
+        }
+    }
+#else
+    // the name for profilers and (on linux) the affinity; priority
+    // stays with the scheduler — raising it outside windows needs
+    // privileges the fleet boxes don't grant
+    if (config.name != nullptr)
+#if defined(__APPLE__)
+        pthread_setname_np(config.name);
+#else
+        pthread_setname_np(pthread_self(), config.name);
+#endif
+#if defined(__linux__)
+    if (config.affinity_mask != 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64; cpu++)
+            if (config.affinity_mask & (1ull << cpu))
+                CPU_SET(cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+#endif
 }
 
-void debug_output(const char* message)
+// presets: the render thread sits pinned at high priority on the first
+// physical core pair — a p-core on every hybrid part shipped so far —
+// while loaders run below normal wherever the scheduler likes, so
+// decode work never displaces frame work. place_threads() below
+// rewrites the masks from the discovered topology before any thread
+// starts; these values are the fallback when discovery comes up empty
+static thread_config_t render_thread_config = { 0x3, THREAD_PRIORITY_HIGHEST, "render" };
+static thread_config_t loader_thread_config = { 0, THREAD_PRIORITY_BELOW_NORMAL, "loader" };
+static thread_config_t main_thread_config = { 0, THREAD_PRIORITY_NORMAL, "main" };
+
+// cpu topology: numa nodes and l3 cache groups, discovered once
+// through GetLogicalProcessorInformationEx. the dual-socket playback
+// boxes pay real cross-node traffic when the two frame threads land
+// on different nodes, and on big single-node parts two threads
+// sharing an l3 hand a cache line over without touching the mesh.
+// single processor group only (64 logical processors); every box this
+// sample targets fits one group
+struct cpu_topology_t
 {
+    static const int max_nodes = 4;
+    static const int max_l3 = 16;
+
+    int node_count = 0;
+    int node_ids[max_nodes] = {};
+    uint64_t node_masks[max_nodes] = {};
+
+    int l3_count = 0;
+    uint64_t l3_masks[max_l3] = {};
+
+    void discover()
+    {
 #if _WIN32
-    OutputDebugStringA(message);
-#else
-#   if defined(__OBJC__)
-    NSLog(@"%s", message);
-#   else
-    NSLog(CFSTR("%s"), message);
-#   endif
+        DWORD size = 0;
+        GetLogicalProcessorInformationEx(RelationAll, NULL, &size);
+        if (size == 0)
+            return;
+
+        std::vector<char> buffer(size);
+        if (!GetLogicalProcessorInformationEx(RelationAll,
+            (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buffer.data(), &size))
+            return;
+
+        for (char* cursor = buffer.data(); cursor < buffer.data() + size;)
+        {
+            auto* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)cursor;
+            cursor += info->Size;
+
+            if (info->Relationship == RelationNumaNode
+                && info->NumaNode.GroupMask.Group == 0
+                && node_count < max_nodes)
+            {
+                node_ids[node_count] = (int)info->NumaNode.NodeNumber;
+                node_masks[node_count] = (uint64_t)info->NumaNode.GroupMask.Mask;
+                node_count++;
+            }
+
+            // one record per cache instance, but some drivers repeat
+            // them per core; the mask is the identity
+            if (info->Relationship == RelationCache
+                && info->Cache.Level == 3
+                && info->Cache.GroupMask.Group == 0)
+            {
+                uint64_t mask = (uint64_t)info->Cache.GroupMask.Mask;
+                bool seen = false;
+                for (int i = 0; i < l3_count; i++)
+                    seen = seen || l3_masks[i] == mask;
+                if (!seen && l3_count < max_l3)
+                    l3_masks[l3_count++] = mask;
+            }
+        }
 #endif
+        // no discovery outside windows yet; the presets stand
+    }
+
+    // first l3 group intersecting the node; a part without l3 records
+    // (or one big slab) just reports the node itself
+    uint64_t l3_on_node(int node) const
+    {
+        for (int i = 0; i < l3_count; i++)
+            if (l3_masks[i] & node_masks[node])
+                return l3_masks[i] & node_masks[node];
+        return node_masks[node];
+    }
+};
+
+namespace {
+    cpu_topology_t cpu_topology;
+    int render_node = -1; // numa node id the frame threads share, -1 unknown
+}
+
+// placement policy, run before any thread starts: the render thread
+// takes the first l3 group of node 0 and the main thread the same
+// node, so the packet handoff between them never crosses the
+// interconnect; loaders move to the second node when there is one,
+// keeping decode bandwidth off the frame node entirely
+static void place_threads()
+{
+    cpu_topology.discover();
+
+    if (cpu_topology.node_count == 0)
+        return; // discovery came up empty; the presets stand
+
+    render_node = cpu_topology.node_ids[0];
+    render_thread_config.affinity_mask = cpu_topology.l3_on_node(0);
+    main_thread_config.affinity_mask = cpu_topology.node_masks[0];
+
+    if (cpu_topology.node_count > 1)
+        loader_thread_config.affinity_mask = cpu_topology.node_masks[1];
+
+    trace("topology: %d node(s), %d l3 group(s), render mask %llx, loader mask %llx\n",
+        cpu_topology.node_count, cpu_topology.l3_count,
+        (unsigned long long)render_thread_config.affinity_mask,
+        (unsigned long long)loader_thread_config.affinity_mask);
 }
 
 namespace {
@@ -97,8 +329,186 @@ namespace {
     float waiting_time = 0.f;
     float cpu_time = 0.f;
     float gpu_time = 0.f;
+
+    // the platform context plumbing lives in gl_context.h now; every
+    // call site goes through this one object, including the adapter
+    // name the profiler shows
+    gl_context_t gl_context;
 }
 
+#if _WIN32
+// dual-gpu laptops route unknown exes to the igpu; both vendors'
+// drivers scan the executable for these exports and pin the context
+// to the discrete part instead
+extern "C"
+{
+    __declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
+    __declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
+}
+
+#pragma comment(lib, "winmm.lib")
+extern "C" __declspec(dllimport) unsigned int __stdcall timeBeginPeriod(unsigned int uPeriod);
+#endif
+
+// frame pacer: swap interval is 0 here, so without a cap the render
+// thread runs free and pegs the gpu. sleep off most of the remaining
+// budget after present and spin-finish the last millisecond; os sleep
+// granularity alone overshoots the deadline even with timeBeginPeriod
+struct frame_pacer_t
+{
+    int target_fps = 60;
+    float error_ms = 0.f; // smoothed overshoot past the deadline
+
+    void pace()
+    {
+        using clock = std::chrono::high_resolution_clock;
+
+        if (target_fps <= 0)
+        {
+            primed = false;
+            return;
+        }
+
+        if (!primed)
+        {
+#if _WIN32
+            timeBeginPeriod(1);
+#endif
+            next = clock::now();
+            primed = true;
+        }
+
+        next += std::chrono::microseconds(1000000 / target_fps);
+
+        auto now = clock::now();
+        if (next < now)
+        {
+            // over budget; re-anchor instead of bursting to catch up
+            next = now;
+            return;
+        }
+
+        auto spin_slice = std::chrono::milliseconds(1);
+        if (next - now > spin_slice)
+            std::this_thread::sleep_for(next - now - spin_slice);
+        while (clock::now() < next) { }
+
+        auto late_us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - next).count();
+        error_ms = glm::mix(error_ms, (float)late_us / 1000.f, 0.05f);
+    }
+
+    std::chrono::high_resolution_clock::time_point next;
+    bool primed = false;
+};
+
+frame_pacer_t frame_pacer;
+
+// frame state recorded by the main thread and consumed by the render thread
+struct frame_packet_t
+{
+    int width = 600;
+    int height = 400;
+    uint64_t frame_index = 0;
+
+    // newest input event at record time: generation plus the main
+    // thread's stamp, so the render thread can close the
+    // input-to-present loop on the first frame that carries it
+    uint32_t input_generation = 0;
+    int64_t input_time_us = 0;
+};
+
+// double-buffered packet exchange: the main thread records frame N+1 into
+// the back packet while the render thread consumes frame N from the front,
+// and publishing is a single atomic swap
+class frame_buffers_t
+{
+private:
+    frame_packet_t packets_[2];
+    std::atomic<int> front_{0};
+
+public:
+    frame_packet_t& back() {
+        return packets_[front_.load(std::memory_order_acquire) ^ 1];
+    }
+
+    void publish() {
+        front_.fetch_xor(1, std::memory_order_acq_rel);
+    }
+
+    frame_packet_t consume() {
+        return packets_[front_.load(std::memory_order_acquire)];
+    }
+};
+
+// the packet exchange is the one structure both frame threads touch
+// every frame; on a multi-node box it lives in memory homed on the
+// render node, matching where both threads were just pinned, instead
+// of wherever the crt heap happened to fault the global in. single
+// node (or no numa api) falls back to a plain static
+frame_buffers_t* frame_packets = nullptr;
+
+static frame_buffers_t* alloc_frame_packets()
+{
+#if _WIN32
+    if (render_node >= 0 && cpu_topology.node_count > 1)
+    {
+        void* memory = VirtualAllocExNuma(GetCurrentProcess(), NULL, sizeof(frame_buffers_t),
+            MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, (DWORD)render_node);
+        if (memory != NULL)
+            return new (memory) frame_buffers_t();
+    }
+#endif
+    static frame_buffers_t local;
+    return &local;
+}
+
+// presentation controller: picks how a finished frame reaches the
+// screen. the installations this sample feeds care about touch latency
+// more than throughput, so the mode is a runtime choice and the
+// controller measures input-to-present alongside it
+struct present_controller_t
+{
+    enum mode_t
+    {
+        mode_immediate = 0, // interval 0, frame pacer is the only throttle
+        mode_vsync,         // swap interval 1
+        mode_dwm,           // interval 0, block on DwmFlush for the compositor's beat (windows; immediate elsewhere)
+        mode_low_latency,   // vsync plus a fence cap on queued frames
+        mode_count
+    };
+
+    int mode = mode_immediate; // set from the ui, consumed on the render thread
+    float latency_ms = 0.f;    // newest input event -> present done, smoothed
+
+    // swap, apply the mode's wait, and sample latency if this frame is
+    // the first to carry fresh input; defined below the context object
+    void present(const frame_packet_t& packet);
+
+    int applied_mode = -1;
+    uint32_t last_input_generation = 0;
+    GLsync in_flight[2] = {}; // swap-ahead cap for the low-latency mode
+    int in_flight_count = 0;
+};
+
+present_controller_t present_controller;
+
+const char* present_mode_names[present_controller_t::mode_count] = {
+    "immediate", "vsync", "dwm", "low latency"
+};
+
+// loader -> render handoff of a finished upload: the loader writes the
+// texture name and a fence, then flips ready last; the render thread
+// adopts the name after a server-side wait on the fence, so the frame
+// orders behind the copy without ever blocking the cpu
+struct texture_upload_t
+{
+    GLuint texture = 0;
+    GLsync fence = 0;
+    std::atomic<bool> ready { false };
+};
+
+texture_upload_t texture_upload;
+
 namespace triangle
 {
     bool setup();
@@ -108,178 +518,92 @@ namespace triangle
     void end_frame();
     void cleanup();
 
-    GLuint create_shader(GLenum type, const char* shaderCode);
-    GLuint create_program(GLuint vertex, GLuint fragment);
-
     GLuint framebuffer;
     GLuint texture;
 
-    GLint position_attribute;
-    GLint texcoord_attribute;
     GLint sampler_location;
 
     GLuint vertex_shader;
     GLuint fragment_shader;
     GLuint program;
 
-    const char* vertex_shader_code = R"__(
-#version 120
-
-attribute vec2 a_position;
-attribute vec2 a_texcoord;
-varying vec2 v_texcoord;
-
-void main()
-{
-    v_texcoord = a_texcoord;
-    gl_Position = vec4(a_position, 0, 1);
-}
-)__";
+    // the triangle comes out of gl_VertexID (fullscreen_pass.h); the
+    // matching fragment stage just samples
+    fullscreen_pass_t fullscreen_pass;
 
     const char* fragment_shader_code = R"__(
-#version 120
+#version 330 core
 
 uniform sampler2D u_sampler;
-varying vec2 v_texcoord;
+in vec2 v_texcoord;
+out vec4 color_out;
+
 void main()
 {
-    gl_FragColor = texture2D(u_sampler, v_texcoord);
+    color_out = texture(u_sampler, v_texcoord);
 }
 )__";
 }
 
-GLuint triangle::create_shader(GLenum type, const char* shaderCode)
-{
-    GLuint id = glCreateShader(type);
-    if (id == 0)
-        return 0;
-
-    glShaderSource(id, 1, &shaderCode, 0);
-    glCompileShader(id);
-
-    GLint compiled = 0;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &compiled);
-    if (compiled == GL_FALSE)
-    {
-        GLint length = 0;
-        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
-        std::vector<GLchar> buffer(length + 1);
-        glGetShaderInfoLog(id, length, 0, buffer.data());
-        printf("%s (%d) %s\n", __FILE__, __LINE__, buffer.data());
-        glDeleteShader(id);
-        return 0;
-    }
-    return id;
-}
-
-GLuint triangle::create_program(GLuint vertex, GLuint fragment)
-{
-    GLuint id = glCreateProgram();
-
-    GLint status = 0;
-    if (vertex != 0)
-    {
-        glAttachShader(id, vertex);
-        if (fragment != 0)
-            glAttachShader(id, fragment);
-        glLinkProgram(id);
-        glGetProgramiv(id, GL_LINK_STATUS, &status);
-
-        if (status == GL_FALSE)
-        {
-            const uint32_t kBufferSize = 512u;  
-            char log[kBufferSize];
-            glGetProgramInfoLog(id, sizeof(log), nullptr, log);
-            printf("%s:%d %d: %s", __FILE__, __LINE__, status, log);
-            return 0;
-        }
-    }
-
-    if (status == GL_FALSE)
-    {
-        glDeleteProgram(id);
-        id = 0;
-        return id;
-    }
-
-    return id;
-}
-
 bool triangle::setup()
 {
-    vertex_shader = create_shader(GL_VERTEX_SHADER, vertex_shader_code);
+    // the shared helpers log through the trace sink instead of the old
+    // printf copies this file carried
+    vertex_shader = gl_create_shader(GL_VERTEX_SHADER, fullscreen_vertex_shader_code);
     if (vertex_shader == GL_NONE)
         return false;
 
-    fragment_shader = create_shader(GL_FRAGMENT_SHADER, fragment_shader_code);
+    fragment_shader = gl_create_shader(GL_FRAGMENT_SHADER, fragment_shader_code);
     if (fragment_shader == GL_NONE)
         return false;
 
-    program = create_program(vertex_shader, fragment_shader);
+    program = gl_create_program(vertex_shader, fragment_shader);
     if (program == GL_NONE)
         return false;
 
-    position_attribute = glGetAttribLocation(program, "a_position");
-    texcoord_attribute = glGetAttribLocation(program, "a_texcoord");
     sampler_location = glGetUniformLocation(program, "u_sampler");
 
-    assert(position_attribute >= 0);
-    assert(texcoord_attribute >= 0);
     assert(sampler_location >= 0);
 
-    GLenum format = GL_RGBA;
-    GLenum internalFormat = GL_RGBA;
-
-    glm::vec4 texel[4] = { 
-        { 1.0, 0.0, 0.0, 1.0 },
-        { 0.0, 1.0, 0.0, 1.0 },
-        { 0.0, 0.0, 1.0, 1.0 },
-        { 1.0, 1.0, 0.0, 1.0 },
-    };
-
-    GLuint instance = 0;
-    glGenTextures(1, &instance);
-    glBindTexture(GL_TEXTURE_2D, instance);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, 2, 2, 0, format, GL_FLOAT, texel);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    fullscreen_pass.setup();
 
-    texture = instance;
+    // the texel upload runs on the loader thread now; the render thread
+    // adopts the name behind the loader's fence on first use
+    texture = 0;
 
     return true;
 }
 
 void triangle::render_frame()
 {
+    // adopt the loader's upload the first frame it shows up: one
+    // server-side wait orders the gpu behind the copy, then the fence
+    // is gone and the texture is just a texture
+    if (texture == 0)
+    {
+        if (!texture_upload.ready.load(std::memory_order_acquire))
+            return; // nothing to draw until the first upload lands
+        glWaitSync(texture_upload.fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(texture_upload.fence);
+        texture_upload.fence = 0;
+        texture = texture_upload.texture;
+    }
+
     glUseProgram(program);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texture);
     glUniform1i(sampler_location, 0);
 
-    float vertices[] = {
-        -1.0, -1.0, 0.0, 0.0,
-        +3.0, -1.0, 2.0, 0.0,
-        -1.0, +3.0, 0.0, 2.0
-    };
-    const void* position = vertices;
-    const void* texcoord = &vertices[2];
-    
-    glVertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), position);
-    glVertexAttribPointer(texcoord_attribute, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), texcoord);
-
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+    // no vertices anywhere: the shader derives the oversized triangle
+    // from gl_VertexID, so the frame carries no client-array upload
+    fullscreen_pass.draw();
 }
 
 void triangle::end_frame()
-{ 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glDisableVertexAttribArray(position_attribute);
-    glDisableVertexAttribArray(texcoord_attribute);
+{
+    // nothing rebinds the framebuffer mid-frame and begin_frame owns
+    // the bind, so there is no state to restore here anymore
 }
 
 void triangle::render()
@@ -303,8 +627,17 @@ static void error_callback(int error, const char* description)
     trace("Error: %s\n", description);
 }
 
+// bumped on every key event; a keystroke counts as damage and wakes
+// the idle loop. the stamp rides the next frame packet so the render
+// thread can measure this event's distance to its present
+static uint32_t input_generation = 0;
+static int64_t input_event_time_us = 0;
+
 static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    input_generation++;
+    input_event_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, GLFW_TRUE);
 }
@@ -324,9 +657,17 @@ void render_profile_ui()
 
     ImGui::PushItemWidth(180.0f);
     ImGui::Indent();
+    ImGui::TextWrapped("%s", gl_context.adapter());
+    ImGui::Separator();
     ImGui::Text("CPU %s: %10.5f ms\n", "Main", cpu_time);
     ImGui::Text("GPU %s: %10.5f ms\n", "Main", gpu_time);
     ImGui::Text("Wait %s: %10.5f ms\n", "Main", waiting_time);
+    ImGui::Text("Pace %s: %10.5f ms\n", "Main", frame_pacer.error_ms);
+    ImGui::Text("Input %s: %10.5f ms\n", "Main", present_controller.latency_ms);
+    ImGui::Separator();
+    for (int i = 0; i < present_controller_t::mode_count; i++)
+        if (ImGui::RadioButton(present_mode_names[i], present_controller.mode == i))
+            present_controller.mode = i;
     ImGui::Separator();
     ImGui::Unindent();
     ImGui::End();
@@ -341,32 +682,6 @@ void render_ui()
 }
 
 namespace {
-
-    void reportLastWindowsError() {
-        LPSTR lpMessageBuffer = nullptr;
-        DWORD dwError = GetLastError();
-
-        if (dwError == 0) {
-            return;
-        }
-        FormatMessage(
-            FORMAT_MESSAGE_ALLOCATE_BUFFER |
-            FORMAT_MESSAGE_FROM_SYSTEM |
-            FORMAT_MESSAGE_IGNORE_INSERTS,
-            nullptr,
-            dwError,
-            MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-            lpMessageBuffer,
-            0, nullptr
-        );
-
-        trace("Windows error code: %d . %s\n", dwError, lpMessageBuffer);
-        LocalFree(lpMessageBuffer);
-    }
-
-    HDC hdc = 0;
-    HWND hwnd = 0;
-    HGLRC context = 0;
     bool thread_running = true;
 }
 
@@ -377,162 +692,101 @@ void triangle::begin_frame()
     glClearDepth(1.0);
     glClearColor(0.3f, 0.3f, 0.5f, 1.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    glEnableVertexAttribArray(position_attribute);
-    glEnableVertexAttribArray(texcoord_attribute);
 }
 
 
-namespace {
-    PFNWGLSWAPINTERVALEXTPROC SwapIntervalEXT = 0;
-    PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribs = 0;
+void present_controller_t::present(const frame_packet_t& packet)
+{
+    using clock = std::chrono::high_resolution_clock;
 
-    void swapIntervalWGL(GLFWwindow* window, int interval)
+    if (mode != applied_mode)
     {
-#if 0
-            if (IsWindowsVistaOrGreater())
-            {
-                // DWM Composition is always enabled on Win8+
-                BOOL enabled = IsWindows8OrGreater();
-
-                // HACK: Disable WGL swap interval when desktop composition is enabled to
-                //       avoid interfering with DWM vsync
-                if (enabled ||
-                    (SUCCEEDED(DwmIsCompositionEnabled(&enabled)) && enabled))
-                    interval = 0;
-            }
-        }
-
-        if (_glfw.wgl.EXT_swap_control)
-            _glfw.wgl.SwapIntervalEXT(interval);
-#endif
-    }
-}
-
-bool wgl_context_create(void* window);
-void wgl_context_destroy();
-
-bool wgl_context_create(void* window)
-{
-    PIXELFORMATDESCRIPTOR pfd = {
-        sizeof(PIXELFORMATDESCRIPTOR),
-        1,
-        PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,    // Flags
-        PFD_TYPE_RGBA,        // The kind of framebuffer. RGBA or palette.
-        32,                   // Colordepth of the framebuffer.
-        0, 0, 0, 0, 0, 0,
-        0,
-        0,
-        0,
-        0, 0, 0, 0,
-        24,                   // Number of bits for the depthbuffer
-        0,                    // Number of bits for the stencilbuffer
-        0,                    // Number of Aux buffers in the framebuffer.
-        PFD_MAIN_PLANE,
-        0,
-        0, 0, 0
-    };
-
-    hwnd = reinterpret_cast<HWND>(window);
-    hdc = ::GetDC(hwnd);
+        // dwm mode keeps the interval at 0 and blocks on the compositor
+        // instead; an interval on top of DwmFlush double-throttles (the
+        // hack note next to swap_interval in gl_context.h)
+        gl_context.swap_interval(mode == mode_vsync || mode == mode_low_latency ? 1 : 0);
 
-    int pixelFormat = ChoosePixelFormat(hdc, &pfd);
-    if (!pixelFormat)
-        return false;
-    if (!DescribePixelFormat(hdc, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd))
-        return false;
-    if (!SetPixelFormat(hdc, pixelFormat, &pfd))
-        return false;
+        for (int i = 0; i < in_flight_count; i++)
+            glDeleteSync(in_flight[i]);
+        in_flight_count = 0;
 
-    HGLRC dummyContext = wglCreateContext(hdc);
-    if (!dummyContext)
-        return false;
-
-    if (!wglMakeCurrent(hdc, dummyContext))
-    {
-        wglDeleteContext(dummyContext);
-        wgl_context_destroy();
-        return false;
+        applied_mode = mode;
     }
 
-    wglCreateContextAttribs = (PFNWGLCREATECONTEXTATTRIBSARBPROC)wglGetProcAddress("wglCreateContextAttribsARB");
-    SwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC)wglGetProcAddress("wglSwapIntervalEXT");
+    gl_context.swap();
+
+    auto wait_tick = clock::now();
 
-    if (wglCreateContextAttribs)
+    if (mode == mode_dwm)
     {
-        int attribs[] = {
-            WGL_CONTEXT_MAJOR_VERSION_ARB, 4,
-            WGL_CONTEXT_MINOR_VERSION_ARB, 1,
-            WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_DEBUG_BIT_ARB,
-            WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
-            0, 0
-        };
-
-        context = wglCreateContextAttribs(hdc, nullptr, attribs);
+#if _WIN32
+        // wait out the compositor's own beat; unlike a swap interval
+        // this tracks dwm's timing exactly
+        DwmFlush();
+#endif
     }
-    else
+    else if (mode == mode_low_latency)
     {
-        context = wglCreateContext(hdc);
-    }
-
-    wglMakeCurrent(NULL, NULL);
-    wglDeleteContext(dummyContext);
-    dummyContext = nullptr;
-
-    if (!context || !wglMakeCurrent(hdc, context)) {
-        DWORD dwError = GetLastError();
-        if (dwError == (0xc0070000 | ERROR_INVALID_VERSION_ARB))
-            trace("WGL: Driver does not support OpenGL version");
-        else if (dwError == (0xc0070000 | ERROR_INVALID_PROFILE_ARB))
-            trace("WGL: Driver does not support the requested OpenGL profile");
-        else if (dwError == (0xc0070000 | ERROR_INCOMPATIBLE_DEVICE_CONTEXTS_ARB))
-            trace("WGL: The share context is not compatible with the requested context");
-        else
-            trace("WGL: Failed to create OpenGL context");
-        wgl_context_destroy();
-        return false;
+        // wgl has no max-frame-latency knob, so cap the driver's queue
+        // with fences: hold here until at most one present is in flight
+        // ahead of us, trading a little throughput for a short queue
+        if (in_flight_count == 2)
+        {
+            glClientWaitSync(in_flight[0], GL_SYNC_FLUSH_COMMANDS_BIT, 1000u * 1000u * 1000u);
+            glDeleteSync(in_flight[0]);
+            in_flight[0] = in_flight[1];
+            in_flight_count = 1;
+        }
+        in_flight[in_flight_count++] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     }
 
-    gladLoadGL();
-
-    return true;
-}
+    waiting_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock::now() - wait_tick).count() / 1000.f;
 
-void wgl_context_destroy()
-{
-    // NOTE: 
-    // if you make two consecutive wlgMakeCurrent(NULL, NULL) calls,
-    // An invalid handle error may occur.
-    // But it seems to work well.
-    wglMakeCurrent(NULL, NULL);
-    if (context) {
-        wglDeleteContext(context);
-        context = NULL;
-    }
-    if (hwnd && hdc) {
-        ReleaseDC(hwnd, hdc);
-        hdc = NULL;
+    // first frame carrying a fresh input stamp closes the
+    // input-to-present loop
+    if (packet.input_generation != last_input_generation)
+    {
+        last_input_generation = packet.input_generation;
+        int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now().time_since_epoch()).count();
+        float sample = (now_us - packet.input_time_us) / 1000.f;
+        latency_ms = latency_ms == 0.f ? sample : glm::mix(latency_ms, sample, 0.25f);
     }
-    hwnd = NULL;
 }
 
+bool loader_start();
+void loader_stop();
+void loader_upload_texture(void*);
+
 semaphore_t semaphore;
 
 void render_init(void* window_handle)
 {
-    if (!wgl_context_create(window_handle)) {
+    if (!gl_context.create(window_handle)) {
         trace("failed to init loop");
         return;
     }
     ImGui_ImplGlfwGL3_CreateDeviceObjects();
     triangle::setup();
-    SwapIntervalEXT(0);
+    // the loader shares the fresh render context, so it comes up second;
+    // without sharing the upload just runs inline here
+    if (!loader_start())
+        loader_upload_texture(nullptr);
+
+    // present_controller applies the interval on its first present
 }
 
 void render_main()
 {
     using timer = std::chrono::high_resolution_clock;
 
+    // take this frame's state in one shot; the main thread is already
+    // recording the next packet into the other buffer
+    frame_packet_t packet = frame_packets->consume();
+    width = packet.width;
+    height = packet.height;
+
     GLuint time_query[2];
 
     auto cpu_tick = timer::now();
@@ -554,14 +808,9 @@ void render_main()
     gpu_time = static_cast<float>(gpu_elapsed / 1e6f);
 
     render_ui();
-    SwapBuffers(hdc);
-    {
-        auto cpu_tick = timer::now();
-        // DwmFlush();
-        auto cpu_tock = timer::now();
-        auto cpu_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(cpu_tock - cpu_tick);
-        waiting_time = static_cast<float>(cpu_elapsed.count() / 1000.0);
-    }
+    present_controller.present(packet);
+
+    frame_pacer.pace();
 }
 
 void render_loop()
@@ -572,43 +821,269 @@ void render_loop()
 
 void render_cleanup()
 {
+    loader_stop();
     triangle::cleanup();
     ImGui_ImplGlfwGL3_InvalidateDeviceObjects();
-    wgl_context_destroy();
+    // the context comes down on the main thread after the join; just
+    // release it from this one
+    gl_context.done_current();
 }
 
-using job_t = std::function<void(void*)>;
-std::queue<job_t> queue_jobs;
+// fixed-size inline callable for the queue: the capture is memcpy'd
+// into local storage, so enqueueing a render job never allocates.
+// everything crossing this boundary captures at most a couple of
+// pointers, so the slot is raw memory and trivially copyable captures
+// are the contract
+class job_t
+{
+public:
+    static const size_t storage_size = 64;
 
-static std::mutex mutex;
+    job_t() = default;
 
-void enqueue_jobs(job_t&& job)
+    template <typename F>
+    job_t(F function)
+    {
+        static_assert(sizeof(F) <= storage_size, "capture does not fit the inline storage");
+        static_assert(std::is_trivially_copyable<F>::value, "the slot is raw memory; captures must be trivially copyable");
+        memcpy(storage_, &function, sizeof(F));
+        invoke_ = [](void* storage, void* argument) { (*(F*)storage)(argument); };
+    }
+
+    void operator()(void* argument) { invoke_(storage_, argument); }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+    alignas(std::max_align_t) char storage_[storage_size] = {};
+    void (*invoke_)(void*, void*) = nullptr;
+};
+
+// bounded mpsc job queue; consumers sleep on the condition variable when
+// idle and drain every queued job in one wakeup instead of re-taking the
+// lock per job. the slots are a preallocated ring, so neither side ever
+// touches the heap
+class job_queue_t
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    queue_jobs.push(job);
+private:
+    static const size_t capacity_ = 64;
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    job_t slots_[capacity_];
+    size_t head_ = 0;   // next slot to drain
+    size_t count_ = 0;
+    bool stopped_ = false;
+
+public:
+    void push(job_t job) {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        not_full_.wait(lock, [this]{ return count_ < capacity_ || stopped_; });
+        if (stopped_)
+            return;
+        slots_[(head_ + count_) % capacity_] = std::move(job);
+        count_++;
+        not_empty_.notify_one();
+    }
+
+    // block until at least one job is queued, then move them all out;
+    // returns the batch size, or 0 once the queue is stopped and empty
+    size_t drain(std::vector<job_t>& out) {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        not_empty_.wait(lock, [this]{ return count_ > 0 || stopped_; });
+        while (count_ > 0) {
+            out.push_back(std::move(slots_[head_]));
+            head_ = (head_ + 1) % capacity_;
+            count_--;
+        }
+        not_full_.notify_all();
+        return out.size();
+    }
+
+    // wake everyone; pending jobs still drain before consumers see 0
+    void stop() {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        stopped_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+};
+
+job_queue_t queue_jobs;
+
+void enqueue_jobs(job_t job)
+{
+    queue_jobs.push(std::move(job));
+}
+
+// resource loader: its own queue and thread, with the shared loader
+// context current, running below normal priority so a burst of uploads
+// at a scene transition never displaces frame work. each upload ends
+// with a fence, and the render thread picks the result up through
+// texture_upload
+namespace {
+    job_queue_t loader_jobs;
+    std::thread loader_thread;
+}
+
+void loader_upload_texture(void*)
+{
+    GLenum format = GL_RGBA;
+    GLenum internalFormat = GL_RGBA;
+
+    glm::vec4 texel[4] = {
+        { 1.0, 0.0, 0.0, 1.0 },
+        { 0.0, 1.0, 0.0, 1.0 },
+        { 0.0, 0.0, 1.0, 1.0 },
+        { 1.0, 1.0, 0.0, 1.0 },
+    };
+
+    GLuint instance = 0;
+    glGenTextures(1, &instance);
+    glBindTexture(GL_TEXTURE_2D, instance);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, 2, 2, 0, format, GL_FLOAT, texel);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    texture_upload.texture = instance;
+    texture_upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // the fence has to reach the driver's queue before anyone can wait
+    // on it; without the flush it can sit in this context forever
+    glFlush();
+    texture_upload.ready.store(true, std::memory_order_release);
+}
+
+void loader_loop()
+{
+    apply_thread_config(loader_thread_config);
+
+    if (!gl_context.make_current_shared())
+        return;
+
+    std::vector<job_t> batch;
+    while (true)
+    {
+        batch.clear();
+        if (loader_jobs.drain(batch) == 0)
+            break;
+        for (auto& job : batch)
+            job(nullptr);
+    }
+
+    gl_context.done_current();
+}
+
+// called on the render thread once its context exists; seeds the queue
+// with the upload that used to run inside triangle::setup
+bool loader_start()
+{
+    if (!gl_context.create_shared())
+        return false;
+
+    loader_thread = std::thread(loader_loop);
+    loader_jobs.push(job_t(loader_upload_texture));
+    return true;
+}
+
+void loader_stop()
+{
+    if (!loader_thread.joinable())
+        return;
+    loader_jobs.stop();
+    loader_thread.join();
+    gl_context.destroy_shared();
 }
 
 void loop(void* window_handle)
 {
-    while (thread_running)
+    apply_thread_config(render_thread_config);
+
+    std::vector<job_t> batch;
+    while (true)
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        if (queue_jobs.size() == 0)
-            continue;
-        job_t job = queue_jobs.front();
-        queue_jobs.pop();
-        job(window_handle);
+        batch.clear();
+        if (queue_jobs.drain(batch) == 0)
+            break;
+        for (auto& job : batch)
+            job(window_handle);
+    }
+}
+
+// wakeup-latency micro-benchmark: the main thread stamps the clock and
+// posts, the worker stamps again on wake; the difference is the handoff
+// latency the frame pipeline pays every frame. ping-pong keeps exactly
+// one post in flight so neither side free-runs
+template <typename S>
+static double semaphore_bench_one()
+{
+    using timer = std::chrono::high_resolution_clock;
+    static const int rounds = 2000;
+
+    S to_worker;
+    S to_main;
+    std::atomic<int64_t> stamp { 0 };
+    int64_t total_ns = 0;
+
+    std::thread worker([&]{
+        for (int i = 0; i < rounds; i++)
+        {
+            to_worker.wait();
+            total_ns += timer::now().time_since_epoch().count() - stamp.load(std::memory_order_relaxed);
+            to_main.set();
+        }
+    });
+
+    for (int i = 0; i < rounds; i++)
+    {
+        stamp.store(timer::now().time_since_epoch().count(), std::memory_order_relaxed);
+        to_worker.set();
+        to_main.wait();
     }
+    worker.join();
+
+    return total_ns / (double)rounds / 1000.0;
+}
+
+static void semaphore_bench()
+{
+    double condvar_us = semaphore_bench_one<mutex_semaphore_t>();
+    double futex_us = semaphore_bench_one<semaphore_t>();
+    trace("semaphore wakeup: mutex+condvar %.2f us, atomic+WaitOnAddress %.2f us\n", condvar_us, futex_us);
 }
 
 int main(void)
 {
+    // topology first: the masks below and the packet placement both
+    // come out of it, and every thread starts after this point
+    place_threads();
+    frame_packets = alloc_frame_packets();
+
+    apply_thread_config(main_thread_config);
+
     glfwSetErrorCallback(error_callback);
 
+    semaphore_bench();
+
     if (!glfwInit())
         exit(EXIT_FAILURE);
 
+#if _WIN32
+    // the wgl backend owns the context; glfw only provides the window
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+#else
+    // glfw owns the context outside windows (glx/egl/nsgl); nothing is
+    // made current here — the render thread takes it in create()
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if defined(__APPLE__)
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+#endif
+#endif
     GLFWwindow* window = glfwCreateWindow(640, 480, "uno", NULL, NULL);
     if (!window)
     {
@@ -618,8 +1093,15 @@ int main(void)
 
 #if defined(GLFW_EXPOSE_NATIVE_WIN32)
     void* window_handle = glfwGetWin32Window(window);
+#else
+    void* window_handle = window;
 #endif
 
+    // main-thread half of context setup, while the window's hints are
+    // still in effect; the render thread runs create() against the
+    // same handle
+    gl_context.prepare(window_handle);
+
     glfwSetKeyCallback(window, key_callback);
 
     ImGui_ImplGlfwGL3_Init(window, false);
@@ -631,15 +1113,51 @@ int main(void)
 
     enqueue_jobs(std::move(b));
 
+    uint64_t frame_index = 0;
+
+    // damage state: the sample's frame is a pure function of the window
+    // size, so an unchanged size with no input means the front buffer
+    // already shows this frame and the loop can idle instead of
+    // publishing another identical packet
+    int last_width = -1;
+    int last_height = -1;
+    uint32_t last_input = input_generation - 1;
+
     int running = GLFW_TRUE;
     while (running)
     {
         glfwPollEvents();
 
-        glfwGetFramebufferSize(window, &width, &height);
+        int frame_width = 0;
+        int frame_height = 0;
+        glfwGetFramebufferSize(window, &frame_width, &frame_height);
+
+        if (frame_width == last_width && frame_height == last_height
+            && input_generation == last_input)
+        {
+            // nothing changed: no packet, no render job, no swap; the
+            // render thread sleeps in its queue until the next event
+            glfwWaitEventsTimeout(0.1);
+            if (glfwWindowShouldClose(window))
+                running = GLFW_FALSE;
+            continue;
+        }
+        last_width = frame_width;
+        last_height = frame_height;
+        last_input = input_generation;
+
+        // record frame N+1 while the render thread consumes frame N
+        frame_packet_t& packet = frame_packets->back();
+        packet.width = frame_width;
+        packet.height = frame_height;
+        packet.frame_index = frame_index++;
+        packet.input_generation = input_generation;
+        packet.input_time_us = input_event_time_us;
+        frame_packets->publish();
+
         semaphore.set();
 
-        enqueue_jobs(std::move(a));
+        enqueue_jobs(a);
 
         if (glfwWindowShouldClose(window))
             running = GLFW_FALSE;
@@ -647,12 +1165,13 @@ int main(void)
 
     enqueue_jobs([](void*) { render_cleanup(); });
     thread_running = false;
+    queue_jobs.stop();
     semaphore.set();
     render_thread.join();
 
 	ImGui_ImplGlfwGL3_Shutdown();
 
-    wgl_context_destroy();
+    gl_context.destroy();
 
     glfwHideWindow(window);
     glfwDestroyWindow(window);
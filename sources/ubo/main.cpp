@@ -1,1157 +1,56 @@
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-#include <stb_image.h>
-#include <imgui.h>
-#include <imgui_impl_glfw.h>
-#include <imgui_impl_glfw_gl3.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp> 
-
-#include <cmath>
-#include <iostream>
-#include <cstdio>
-#include <cstdlib>
-#include <chrono>
-#include <vector>
-#include <sstream>
-#include <algorithm>
-#include <functional>
-
-#include "handle_alloc.h"
-
 #define USE_CORE_PROFILE 0
 #define USE_GLES 0
 #define USE_TEST_CODE 0
+#define USE_GL43 0
+#define USE_INSTANCED 0
+#define USE_BINDLESS 0
+#define USE_PARTIAL_REDRAW 0
+#define USE_SLIM_GL_LOADER 0
 
-namespace gl3 {
-    
-    const char* vertex_shader_code = R"__(
-#version 330 core
-
-layout(location = 0) in vec2 a_position;
-layout(location = 1) in vec2 a_texcoord;
-out vec2 v_texcoord;
-
-void main()
-{
-    v_texcoord = a_texcoord;
-    gl_Position = vec4(a_position, 0, 1);
-}
-)__";
-
-    const char* fragment_shader_code = R"__(
-#version 330 core
-
-uniform sampler2D u_sampler;
-layout(std140) uniform u_fragment
-{
-    vec4 data[4];
-} u_frag;
-
-in vec2 v_texcoord;
-out vec4 color_out;
-
-void main()
-{
-    color_out = texture(u_sampler, v_texcoord) * vec4(1.0 + 0.05*u_frag.data[0].rrr, 1.0);
-}
-)__";
-}
-
-namespace gl2
-{ 
-    const char* vertex_shader_code = R"__(
-#version 120
-
-attribute vec2 a_position;
-attribute vec2 a_texcoord;
-varying vec2 v_texcoord;
-
-void main()
-{
-    v_texcoord = a_texcoord;
-    gl_Position = vec4(a_position, 0, 1);
-}
-)__";
-
-    const char* fragment_shader_code = R"__(
-#version 120
-
-struct u_frags
-{
-    vec4 data[4];
-};
-
-uniform u_frags u_frag;
-uniform sampler2D u_sampler;
-varying vec2 v_texcoord;
-
-void main()
-{
-    gl_FragColor = texture2D(u_sampler, v_texcoord) * vec4(1.0 + 0.05*u_frag.data[0].rrr, 1.0);
-}
-)__";
-}
-
-#if _WIN32
-extern "C" __declspec(dllimport) void __stdcall OutputDebugStringA(const char* _str);
-#else
-#   if defined(__OBJC__)
-#       import <Foundation/NSObjCRuntime.h>
-#   else
-#       include <CoreFoundation/CFString.h>
-        extern "C" void NSLog(CFStringRef _format, ...);
-#   endif
-#endif
-
-void debug_output(const char* message);
-void trace(const char* format, ...);
-
-void trace(const char* format, ...)
-{
-    const int kLength = 1024;
-    char buffer[kLength + 1] = {0,};
-    
-    va_list argList;
-    va_start(argList, format);
-    int len = vsnprintf(buffer, kLength, format, argList);
-    va_end(argList);
-    if (len > kLength)
-        len = kLength;
-    buffer[len] = '\0';
-
-    debug_output(buffer);
-}
-
-void debug_output(const char* message)
-{
-#if _WIN32
-    OutputDebugStringA(message);
-#else
-#   if defined(__OBJC__)
-    NSLog(@"%s", message);
-#   else
-    NSLog(CFSTR("%s"), message);
-#   endif
-#endif
-}
-
-namespace {
-    int num_frac = 10;
-    const int max_frac = 10000;
-
-    GLint samples = 4;
-    GLint uniform_alignment = 0;
-    int width = 600;
-    int height = 400;
-    float cpu_time = 0.f;
-    float gpu_time = 0.f;
-    float draws_per_sec = 0.f;
-    float per_frame_sec = 0.f;
-
-    uint32_t draw_count = 0;
-}
-
-typedef uint32_t index_t;
-
-struct vertex_t
-{
-    float pos[2];
-    float uv[2];
-};
-
-struct mesh_t {
-    int32_t offset;
-    int32_t size;
-};
-
-struct draw_command_t 
-{
-    struct uniform_t {
-        GLuint id;
-        GLint offset;
-        GLuint size;
-        GLint slot;
-    };
-
-    mesh_t mesh;
-    uniform_t uniform;
-    GLuint texture;
-};
-
-struct uniform_t
-{
-    glm::vec4 data[4];
-};
-
-#define GL_TEXTURE_EXTERNAL_OES 0x00008d65
-
-constexpr size_t get_index_for_texture_target(GLuint target) noexcept
-{
-    switch (target)
-    {
-    case GL_TEXTURE_2D:             return 0;
-    case GL_TEXTURE_2D_ARRAY:       return 1;
-    case GL_TEXTURE_CUBE_MAP:       return 2;
-    case GL_TEXTURE_2D_MULTISAMPLE: return 3;
-    case GL_TEXTURE_EXTERNAL_OES:   return 4;
-    default:                        return 0;
-    }
-}
-
-static constexpr const size_t texture_target_count = 5;
-static constexpr const size_t max_texture_unit_count = 8;
-
-struct texture_state_t {
-    GLuint activate = 0;
-    struct {
-        struct {
-            GLuint instance = 0;
-        } target[texture_target_count];
-    } unit[max_texture_unit_count];
-};
-
-struct program_state_t {
-    struct {
-        GLuint instance = 0;
-    } program;
-};
-
-template <typename T, typename F>
-inline void update_state(T& state, const T& expected, F functor, bool force = false) noexcept
-{
-    if (force || state != expected)
-    {
-        state = expected;
-        functor();
-    }
-}
-
-struct draw_list_t 
-{
-    struct command_t 
-    {
-        int32_t count;
-        int32_t offset;
-    };
-
-    draw_list_t();
-
-    void reserve(int32_t vertex_count, int32_t index_count);
-    void draw(const vertex_t* vertex, int32_t vertex_count, const index_t* index, int32_t index_count);
-
-    std::vector<vertex_t> vertices; 
-    std::vector<index_t> indices;
-    std::vector<command_t> commands;
-
-    vertex_t* vertex_pointer;
-    index_t* index_pointer;
-};
-
-draw_list_t::draw_list_t() :
-    vertex_pointer(nullptr),
-    index_pointer(nullptr)
-{
-}
-
-void draw_list_t::reserve(int32_t vertex_count, int32_t index_count)
-{
-    assert(index_count >= 0);
-    assert(vertex_count >= 0);
-
-    size_t old_vertex_size = vertices.size();
-    vertices.resize(old_vertex_size + vertex_count);
-    vertex_pointer = vertices.data();
-    vertex_pointer += old_vertex_size;
-
-    size_t old_index_size = indices.size();
-    indices.resize(old_index_size + index_count);
-    index_pointer = indices.data();
-    index_pointer += old_index_size;
-}
-
-void draw_list_t::draw(const vertex_t* vertex, int32_t vertex_count, const index_t* index, int32_t index_count)
-{
-    const size_t index_offset = indices.size();
-    const size_t vertex_offset = vertices.size();
-
-    reserve(vertex_count, index_count);
-    for (int i = 0; i < vertex_count; i++)
-        vertex_pointer[i] = vertex[i];
-    for (int i = 0; i < index_count; i++)
-        index_pointer[i] = index[i] + vertex_offset;
-
-    commands.push_back({index_count, (int32_t)index_offset});
-}
-
-struct texture_handle_t
-{
-    handle_t index;
-};
-
-struct texture_desc_t
-{
-    int32_t width;
-    int32_t height;
-    uint8_t* data;
-};
-
-struct renderer_opengl_t
-{
-public:
-
-    virtual bool setup();
-    virtual void begin_frame();
-    virtual void end_frame();
-    virtual void uniform(const uniform_t& uniform) = 0;
-    virtual void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) = 0;
-    virtual void texture(texture_handle_t texture) = 0;
-
-    virtual void render_ui();
-    virtual void render_profile_ui();
-    virtual void cleanup();
-
-    inline void activate_texture(GLuint unit);
-    inline void bind_texture(GLuint unit, GLuint target, GLuint instance);
-    inline void unbind_texture(GLuint target, GLuint instance);
-
-    virtual void use_program(GLuint instance);
-
-    virtual GLuint create_shader(GLenum type, const char* shaderCode);
-    virtual GLuint create_program(GLuint vertex, GLuint fragment);
-
-    GLuint create_texture_impl(int32_t width, int32_t height, uint8_t* data);
-    GLuint create_texture_impl(std::string path);
-
-    virtual texture_handle_t create_texture(const texture_desc_t& desc);
-    virtual void destroy_texture(texture_handle_t handle);
-    virtual void destroy_texture_lazy(texture_handle_t handle);
-
-    static const uint8_t max_texture = 128;
-    handle_alloc_t<max_texture> handle_alloc;
-    GLuint textures[max_texture];
-
-    texture_state_t texture_state;
-    program_state_t program_state;
-};
-
-void renderer_opengl_t::activate_texture(GLuint unit)
-{
-    update_state(texture_state.activate, unit, [&]() {
-        glActiveTexture(GL_TEXTURE0 + unit);
-    });
-}
-
-void renderer_opengl_t::bind_texture(GLuint unit, GLuint target, GLuint instance)
-{
-    uint8_t target_index = (uint8_t)get_index_for_texture_target(target);
-    update_state(texture_state.unit[unit].target[target_index].instance, instance, [&](){
-        activate_texture(unit);
-        glBindTexture(target, instance);
-    });
-}
-
-void renderer_opengl_t::unbind_texture(GLuint target, GLuint instance)
-{
-    uint8_t target_index = (uint8_t)get_index_for_texture_target(target);
-    for (size_t unit = 0; unit < max_texture_unit_count; unit++)
-    {
-        if (texture_state.unit[unit].target[target_index].instance == instance)
-            bind_texture(unit, target, 0);
-    }
-}
-
-void renderer_opengl_t::use_program(GLuint instance)
-{
-    glUseProgram(instance);
-}
-
-GLuint renderer_opengl_t::create_shader(GLenum type, const char* shaderCode)
-{
-    GLuint id = glCreateShader(type);
-    if (id == 0)
-        return 0;
-
-    glShaderSource(id, 1, &shaderCode, 0);
-    glCompileShader(id);
-
-    GLint compiled = 0;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &compiled);
-    if (compiled == GL_FALSE)
-    {
-        GLint length = 0;
-        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
-        std::vector<GLchar> buffer(length + 1);
-        glGetShaderInfoLog(id, length, 0, buffer.data());
-        trace("%s (%d) %s\n", __FILE__, __LINE__, buffer.data());
-        glDeleteShader(id);
-        return 0;
-    }
-    return id;
-}
-
-GLuint renderer_opengl_t::create_program(GLuint vertex, GLuint fragment)
-{
-    GLuint id = glCreateProgram();
-
-    GLint status = 0;
-    if (vertex != 0)
-    {
-        glAttachShader(id, vertex);
-        if (fragment != 0)
-            glAttachShader(id, fragment);
-        glLinkProgram(id);
-        glGetProgramiv(id, GL_LINK_STATUS, &status);
-
-        if (status == GL_FALSE)
-        {
-            const uint32_t kBufferSize = 512u;  
-            char log[kBufferSize];
-            glGetProgramInfoLog(id, sizeof(log), nullptr, log);
-            trace("%s:%d %d: %s", __FILE__, __LINE__, status, log);
-            return 0;
-        }
-    }
-
-    if (status == GL_FALSE)
-    {
-        glDeleteProgram(id);
-        id = 0;
-        return id;
-    }
-
-    return id;
-}
-
-GLuint renderer_opengl_t::create_texture_impl(int32_t width, int32_t height, uint8_t* data)
-{
-    GLenum format = GL_RGBA;
-    GLenum internalFormat = GL_RGBA;
-
-    GLuint instance = 0;
-    glGenTextures(1, &instance);
-    glBindTexture(GL_TEXTURE_2D, instance);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return instance;
-}
-
-GLuint renderer_opengl_t::create_texture_impl(std::string path)
-{
-    stbi_set_flip_vertically_on_load(true);
-
-    FILE* fp = fopen(path.c_str(), "rb");
-    if (fp == NULL) 
-        return 0;
-
-    fseek(fp, 0, SEEK_END);
-    long length = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    std::vector<char> storage(length);;
-    length = fread(storage.data(), 1, length, fp);
-    fclose(fp);
-
-	GLenum target = GL_TEXTURE_2D;
-    GLenum type = GL_UNSIGNED_BYTE;
-    int width = 0, height = 0, nrComponents = 0;
-    stbi_uc* imagedata = stbi_load_from_memory((stbi_uc*)storage.data(), (int)length, &width, &height, &nrComponents, 0);
-    if (!imagedata) 
-        return 0;
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    GLuint instance = 0;
-    glGenTextures(1, &instance);
-    glBindTexture(target, instance);
-    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(target, 0, GL_RGB, width, height, 0, GL_RGB, type, imagedata);
-    glBindTexture(target, 0);
-
-    stbi_image_free(imagedata);
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-
-    return instance;
-}
-
-texture_handle_t renderer_opengl_t::create_texture(const texture_desc_t& desc)
-{
-    texture_handle_t handle = { handle_alloc.alloc() };
-    textures[handle.index] = create_texture_impl(desc.width, desc.height, desc.data);
-    return handle;
-}
-
-void renderer_opengl_t::destroy_texture(texture_handle_t handle)
-{
-    if (handle.index == invalid_handle_t )
-        return;
-
-    GLuint& texture = textures[handle.index];
-    glDeleteTextures(1, &texture);
-    texture = 0;
-
-    handle_alloc.free(handle.index);
-}
-
-void renderer_opengl_t::destroy_texture_lazy(texture_handle_t handle)
-{
-    destroy_texture(handle);
-}
-
-bool renderer_opengl_t::setup()
-{
-    memset(textures, 0, sizeof(textures));
-    return true;
-}
-
-void renderer_opengl_t::begin_frame()
-{ 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glViewport(0, 0, width, height);
-#if USE_CORE_PROFILE
-    glClearDepthf(1.0);
-#else
-    glClearDepth(1.0);
-#endif
-    glClearColor(0.3f, 0.3f, 0.5f, 1.f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    draw_count = num_frac;
-}
-
-void renderer_opengl_t::end_frame()
-{ 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void renderer_opengl_t::cleanup()
-{
-}
-
-class renderer_gl2_t : public renderer_opengl_t
-{
-public:
-
-    bool setup() override;
-    void begin_frame() override;
-    void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) override;
-    void uniform(const uniform_t& uniform) override;
-    void texture(texture_handle_t texture) override;
-    void end_frame() override;
-    void cleanup() override;
-
-    GLint position_attribute;
-    GLint texcoord_attribute;
-    GLint sampler_location;
-    GLint uniform_location[4];
-
-    GLuint vertex_shader;
-    GLuint fragment_shader;
-    GLuint program;
-};
-
-bool renderer_gl2_t::setup()
-{
-    renderer_opengl_t::setup();
-
-    vertex_shader = create_shader(GL_VERTEX_SHADER, gl2::vertex_shader_code);
-    if (vertex_shader == GL_NONE)
-        return false;
-
-    fragment_shader = create_shader(GL_FRAGMENT_SHADER, gl2::fragment_shader_code);
-    if (fragment_shader == GL_NONE)
-        return false;
-
-    program = create_program(vertex_shader, fragment_shader);
-    if (program == GL_NONE)
-        return false;
-
-    position_attribute = glGetAttribLocation(program, "a_position");
-    texcoord_attribute = glGetAttribLocation(program, "a_texcoord");
-    sampler_location = glGetUniformLocation(program, "u_sampler");
-    uniform_location[0] = glGetUniformLocation(program, "u_frag.data[0]");
-    uniform_location[1] = glGetUniformLocation(program, "u_frag.data[1]");
-    uniform_location[2] = glGetUniformLocation(program, "u_frag.data[2]");
-    uniform_location[3] = glGetUniformLocation(program, "u_frag.data[3]");
-
-    assert(position_attribute >= 0);
-    assert(texcoord_attribute >= 0);
-    assert(sampler_location >= 0);
-    assert(uniform_location[0] >= 0);
-
-    use_program(program);
-
-    // initialize once will be ok
-    glUniform1i(sampler_location, 0);
-
-    return true;
-}
-
-void renderer_gl2_t::begin_frame()
-{
-    renderer_opengl_t::begin_frame();
-
-    use_program(program);
-
-    glEnableVertexAttribArray(position_attribute);
-    glEnableVertexAttribArray(texcoord_attribute);
-}
-
-void renderer_gl2_t::draw(vertex_t* vertices, int vertex_count, index_t*, int)
-{
-    const void* position = (size_t*)&vertices->pos;
-	const void* texcoord = (size_t*)&vertices->uv;
-
-    glVertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), position);
-    glVertexAttribPointer(texcoord_attribute, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), texcoord);
-
-    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
-}
-
-void renderer_gl2_t::uniform(const uniform_t& uniform)
-{
-    glUniform4fv(uniform_location[0], 1, (const float*)&uniform.data[0]);
-    glUniform4fv(uniform_location[1], 1, (const float*)&uniform.data[1]);
-    glUniform4fv(uniform_location[2], 1, (const float*)&uniform.data[2]);
-    glUniform4fv(uniform_location[3], 1, (const float*)&uniform.data[3]);
-}
-
-void renderer_gl2_t::texture(texture_handle_t texture)
-{
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textures[texture.index]);
-}
-
-void renderer_gl2_t::end_frame() 
-{
-    renderer_opengl_t::end_frame();
-
-    glDisableVertexAttribArray(position_attribute);
-    glDisableVertexAttribArray(texcoord_attribute);
-}
-
-void renderer_gl2_t::cleanup()
-{
-    renderer_opengl_t::cleanup();
-
-    glDeleteProgram(program);
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-}
-
-class renderer_gl3_t : public renderer_opengl_t
-{
-public:
-
-    bool setup() override;
-    void begin_frame() override;
-    void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) override;
-    void uniform(const uniform_t& uniform) override;
-    void texture(texture_handle_t texture) override;
-    void end_frame() override;
-    void cleanup() override;
-
-    void use_program(GLuint instance);
-
-    texture_handle_t create_texture(const texture_desc_t& desc) override;
-    void destroy_texture(texture_handle_t handle) override;
-    void destroy_texture_lazy(texture_handle_t handle) override;
-
-    GLint position_attribute;
-    GLint texcoord_attribute;
-    GLint sampler_location;
-
-    GLuint vertex_shader;
-    GLuint fragment_shader;
-    GLuint program;
-
-    GLuint vao;
-    GLuint vbo;
-    GLuint ibo;
-    GLuint ubo;
-    GLint block_index;
-    draw_list_t draw_list;
-
-    GLint uniform_location[4];
-
-    std::vector<texture_handle_t> free_textures;
-    std::vector<texture_handle_t> bind_textures;
-    std::vector<uniform_t> uniforms;
-    std::vector<char> uniform_buffer;
-
-    std::vector<draw_command_t> draw_commands;
-};
-
-bool renderer_gl3_t::setup()
-{
-    renderer_opengl_t::setup();
-
-    vertex_shader = create_shader(GL_VERTEX_SHADER, gl3::vertex_shader_code);
-    if (vertex_shader == GL_NONE)
-        return false;
-
-    fragment_shader = create_shader(GL_FRAGMENT_SHADER, gl3::fragment_shader_code);
-    if (fragment_shader == GL_NONE)
-        return false;
-
-    program = create_program(vertex_shader, fragment_shader);
-    if (program == GL_NONE)
-        return false;
-
-    position_attribute = glGetAttribLocation(program, "a_position");
-    texcoord_attribute = glGetAttribLocation(program, "a_texcoord");
-    sampler_location = glGetUniformLocation(program, "u_sampler");
-    block_index = glGetUniformBlockIndex(program, "u_fragment");
-
-    uniform_location[0] = glGetUniformLocation(program, "u_frag.data[0]");
-    uniform_location[1] = glGetUniformLocation(program, "u_frag.data[1]");
-    uniform_location[2] = glGetUniformLocation(program, "u_frag.data[2]");
-    uniform_location[3] = glGetUniformLocation(program, "u_frag.data[3]");
-
-    assert(position_attribute >= 0);
-    assert(texcoord_attribute >= 0);
-    assert(sampler_location >= 0);
-    assert(block_index >= 0);
-
-    use_program(program);
-
-    // initialize once will be ok
-    glUniform1i(sampler_location, 0);
-
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-    glGenBuffers(1, &ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-
-    glGenBuffers(1, &ubo);
-
-    return true;
-}
-
-void renderer_gl3_t::begin_frame()
-{
-    renderer_opengl_t::begin_frame();
-
-    draw_list.index_pointer = nullptr;
-    draw_list.vertex_pointer = nullptr;
-    draw_list.vertices.clear();
-    draw_list.indices.clear();
-    draw_list.commands.clear();
-
-    uniforms.clear();
-    uniform_buffer.clear();
-    draw_commands.clear();
-    bind_textures.clear();
-}
-
-void renderer_gl3_t::draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count)
-{
-    draw_list.draw((vertex_t*)vertices, vertex_count, indices, index_count);
-}
-
-void renderer_gl3_t::uniform(const uniform_t& uniform)
-{
-    uniforms.push_back(uniform);
-}
-
-void renderer_gl3_t::texture(texture_handle_t texture)
-{
-    bind_textures.push_back(texture);
-}
-
-void renderer_gl3_t::use_program(GLuint instance)
-{
-    update_state(program_state.program.instance, instance, [&](){
-        glUseProgram(instance);
-    });
-}
-
-template <typename T>
-inline T alignup(T num, size_t align)
-{
-    return (T)(((size_t)num + align - 1) & ~(align - 1));
-}
-
-struct uniform_manager_t
-{
-    GLuint ubo;
-};
-
-void renderer_gl3_t::end_frame() 
-{
-    GLsizeiptr vertex_buffer_size = sizeof(vertex_t) * draw_list.vertices.size();
-    const void *vertex_buffer_pointer = draw_list.vertices.data();
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_size, vertex_buffer_pointer, GL_STREAM_DRAW);
-
-    GLsizeiptr index_buffer_size = sizeof(index_t) * draw_list.indices.size();
-    const void *index_buffer_pointer = draw_list.indices.data();
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_size, index_buffer_pointer, GL_STREAM_DRAW);
-
-    GLint uniform_buffer_offset_alignment;
-    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_offset_alignment);
-    uniform_buffer_offset_alignment = std::max(1, uniform_buffer_offset_alignment);
-
-    int32_t block_size = alignup(sizeof(uniforms), uniform_buffer_offset_alignment);
-
-#if 0
-    uniform_buffer.resize(block_size * uniforms.size(), 0);
-
-    char* data = uniform_buffer.data();
-
-    struct uniform_offset_t
-    {
-        int32_t offset;
-        uint32_t size;
-    };
-    std::vector<uniform_offset_t> uniform_offsets(uniforms.size());
-    for (int32_t i = 0; i < (int32_t)(uniforms.size()); i++) 
-    {
-        memcpy(data, &uniforms[i], sizeof(uniform_t));
-        data += block_size;
-        uniform_offsets[i] = uniform_offset_t({ i * block_size, (uint32_t)block_size });
-    }
-
-    GLsizeiptr ubo_buffer_size = uniform_buffer.size();
-    const void *ubo_buffer_pointer = uniform_buffer.data();
-
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    glBufferData(GL_UNIFORM_BUFFER, ubo_buffer_size, ubo_buffer_pointer, GL_DYNAMIC_DRAW);
-#endif
-
-    draw_commands.resize(num_frac);
-    for (int i = 0; i < num_frac; i++)
-    {
-        draw_commands[i].mesh.size = draw_list.commands[i].count;
-        draw_commands[i].mesh.offset = draw_list.commands[i].offset;
-        // draw_commands[i].uniform = { ubo, uniform_offsets[i].offset, uniform_offsets[i].size, block_index };
-        draw_commands[i].texture = textures[bind_textures[i].index];
-    }
-
-    use_program(program);
-
-    // since 3.0
-    // without below line, bind block_point according to shader code's define
-    // const GLuint block_point = 0;
-    // glUniformBlockBinding(program, block_index, block_point);
-
-    glEnableVertexAttribArray(position_attribute);
-    glEnableVertexAttribArray(texcoord_attribute);
-
-    const void* position = (size_t*)0;
-    const void* texcoord = (size_t*)(2 * sizeof(float));
-
-    glVertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), position);
-    glVertexAttribPointer(texcoord_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), texcoord);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-
-    for (int i = 0; i < num_frac; i++) {
-        const auto& call = draw_commands[i];
-        const auto& ubo = call.uniform;
-        const auto& uniform = uniforms[i];
-        // glBindBufferRange(GL_UNIFORM_BUFFER, ubo.slot, ubo.id, ubo.offset, ubo.size);
-        glUniform4fv(uniform_location[0], 1, (const float*)&uniform.data[0]);
-        glUniform4fv(uniform_location[1], 1, (const float*)&uniform.data[1]);
-        glUniform4fv(uniform_location[2], 1, (const float*)&uniform.data[2]);
-        glUniform4fv(uniform_location[3], 1, (const float*)&uniform.data[3]);
-
-        bind_texture(0, GL_TEXTURE_2D, call.texture);
-
-        glDrawElements(GL_TRIANGLES, call.mesh.size, GL_UNSIGNED_INT, (const void*)(call.mesh.offset * sizeof(4)));
-    }
-
-    glDisableVertexAttribArray(position_attribute);
-    glDisableVertexAttribArray(texcoord_attribute);
-
-    for (auto handle : free_textures)
-        destroy_texture(handle);
-    free_textures.clear();
-}
-
-void renderer_gl3_t::cleanup()
-{
-    renderer_opengl_t::cleanup();
-
-    for (auto handle : free_textures) {
-        GLuint& texture = textures[handle.index];
-        glDeleteTextures(1, &texture);
-        texture = 0;
-    }
-    free_textures.clear();
-
-    glDeleteProgram(program);
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-
-    glBindVertexArray(0);
-    glDeleteVertexArrays(1, &vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &vbo);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &ibo);
-
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glDeleteBuffers(1, &ubo);
-}
-
-texture_handle_t renderer_gl3_t::create_texture(const texture_desc_t& desc)
-{
-    texture_handle_t handle = { handle_alloc.alloc() };
-    textures[handle.index] = create_texture_impl(desc.width, desc.height, desc.data);
-    return handle;
-}
-
-void renderer_gl3_t::destroy_texture(texture_handle_t handle)
-{
-    unbind_texture(GL_TEXTURE_2D, textures[handle.index]);
-    renderer_opengl_t::destroy_texture(handle);
-}
-
-void renderer_gl3_t::destroy_texture_lazy(texture_handle_t handle)
-{
-    if (handle.index == invalid_handle_t)
-        return;
-    free_textures.push_back(handle);
-}
-
-// buffer update per drawcall
-class renderer_gl31_t : public renderer_gl3_t
-{
-public:
-    
-    void begin_frame() override;
-    void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) override;
-    void uniform(const uniform_t& uniform) override;
-    void texture(texture_handle_t texture) override;
-    void end_frame() override;
-};
-
-void renderer_gl31_t::begin_frame()
-{
-    renderer_opengl_t::begin_frame();
-    
-    use_program(program);
-    
-    glEnableVertexAttribArray(position_attribute);
-    glEnableVertexAttribArray(texcoord_attribute);
-    
-    const void* position = (size_t*)0;
-    const void* texcoord = (size_t*)(2 * sizeof(float));
-    
-    glVertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), position);
-    glVertexAttribPointer(texcoord_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), texcoord);
-}
-
-void renderer_gl31_t::draw(vertex_t* vertices, int vertex_count, index_t*, int)
-{
-    auto vertex_buffer_size = vertex_count * sizeof(vertex_t);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertex_buffer_size, vertices, GL_STREAM_DRAW);
-
-    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
-}
-
-void renderer_gl31_t::uniform(const uniform_t& uniform)
-{
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(uniform_t), &uniform, GL_DYNAMIC_DRAW);
-
-    glBindBufferBase(GL_UNIFORM_BUFFER, block_index, ubo);
-}
-
-void renderer_gl31_t::texture(texture_handle_t texture)
-{
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textures[texture.index]);
-}
-
-void renderer_gl31_t::end_frame()
-{
-    glDisableVertexAttribArray(position_attribute);
-    glDisableVertexAttribArray(texcoord_attribute);
-}
+#include "renderer.h"
+#include "gpu_task.h"
 
 static void error_callback(int error, const char* description)
 {
     trace("Error: %s\n", description);
 }
 
+static bool trace_dump_requested = false;
+static bool capture_trigger_requested = false;
+
+// bumped on every key event so keystrokes register as damage even when
+// nothing they trigger changes the scene hash directly
+static uint32_t input_generation = 0;
+
 static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    input_generation++;
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, GLFW_TRUE);
+    if (key == GLFW_KEY_T && action == GLFW_PRESS)
+        trace_dump_requested = true;
+    if (key == GLFW_KEY_C && action == GLFW_PRESS)
+        capture_trigger_requested = true;
+    if (key == GLFW_KEY_H && action == GLFW_PRESS)
+        hud_visible = !hud_visible;
+    // stamp the event for the input-to-present estimate; the frame that
+    // polls this event fences its swap against the stamp
+    latency_tracker.on_input();
 }
 
-void renderer_opengl_t::render_profile_ui()
+// event-driven size updates: the globals move only when the window
+// does, and the tracker starts the settle countdown that holds off
+// offscreen-target reallocation while the user is still dragging
+static void framebuffer_size_callback(GLFWwindow* window, int new_width, int new_height)
 {
-    ImGui::SetNextWindowPos(
-        ImVec2(width - 200.f - 10.f, 10.f),
-        ImGuiSetCond_FirstUseEver);
-
-    ImGui::Begin("Profiler",
-        NULL,
-        ImVec2(200.f, height - 20.0f),
-        ImGuiWindowFlags_AlwaysAutoResize);
-
-    ImGui::PushItemWidth(180.0f);
-    ImGui::Indent();
-    ImGui::Text("CPU %s: %10.5f ms\n", "Main", cpu_time);
-    ImGui::Text("GPU %s: %10.5f ms\n", "Main", gpu_time);
-    ImGui::Text("Draws/s: %.2f", draws_per_sec);
-    ImGui::Text("Draw Count: %d\n", draw_count);
-    ImGui::Text("FPS: %f\n", 1.f/per_frame_sec);
-    ImGui::Separator();
-    ImGui::Unindent();
-    ImGui::SliderInt("", &num_frac, 10, 10000);
-    ImGui::End();
-}
-
-void renderer_opengl_t::render_ui()
-{
-    render_profile_ui();
-    ImGui::Render();
-    ImGui::EndFrame();
-}
-
-void APIENTRY opengl_callback(GLenum source,
-    GLenum type,
-    GLuint id,
-    GLenum severity,
-    GLsizei length,
-    const GLchar* message,
-    const void* userParam)
-{
-    using namespace std;
-
-    // ignore these non-significant error codes
-    if (id == 131169 || id == 131185 || id == 131218 || id == 131204 || id == 131184)
-        return;
-
-    stringstream out;
-
-    out << "---------------------OPENGL-CALLBACK-START------------" << endl;
-    out << "message: " << message << endl;
-    out << "type: ";
-    switch (type) {
-    case GL_DEBUG_TYPE_ERROR:
-        out << "ERROR";
-        break;
-    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
-        out << "DEPRECATED_BEHAVIOR";
-        break;
-    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
-        out << "UNDEFINED_BEHAVIOR";
-        break;
-    case GL_DEBUG_TYPE_PORTABILITY:
-        out << "PORTABILITY";
-        break;
-    case GL_DEBUG_TYPE_PERFORMANCE:
-        out << "PERFORMANCE";
-        break;
-    case GL_DEBUG_TYPE_OTHER:
-        out << "OTHER";
-        break;
-    }
-    out << endl;
-
-    out << "id: " << id << endl;
-    out << "severity: ";
-    switch (severity) {
-    case GL_DEBUG_SEVERITY_LOW:
-        out << "LOW";
-        break;
-    case GL_DEBUG_SEVERITY_MEDIUM:
-        out << "MEDIUM";
-        break;
-    case GL_DEBUG_SEVERITY_HIGH:
-        out << "HIGH";
-        break;
-    }
-    out << endl;
-    out << "---------------------OPENGL-CALLBACK-END--------------" << endl;
-
-    trace(out.str().c_str());
-}
-
-void render_background_texture(renderer_opengl_t& render)
-{
-    render.begin_frame();
-
-    static texture_handle_t texture = { invalid_handle_t };
-
-    int texture_index = -1;
-
-	for (int i = 0; i < num_frac; i++)
-	{
-		float sx = -1.f + 2.f / num_frac * i;
-		float ex = -1.f + 2.f / num_frac * (i + 1);
-		float tsx = 0.f + 1.f / num_frac * i;
-		float tex = 0.f + 1.f / num_frac * (i + 1);
-
-		float vertices[] = {
-			sx, -1.0, tsx, 0.0,
-			ex, -1.0, tex, 0.0,
-			sx, 1.0, tsx, 1.0,
-
-			sx, 1.0, tsx, 1.0,
-			ex, -1.0, tex, 0.0,
-			ex, 1.0, tex, 1.0,
-		};
-
-        uint32_t indices[] = { 0, 1, 2, 3, 4, 5 };
-
-        uniform_t data;
-        memset(&data, 0, sizeof(data));
-        data.data[0].r = float(i + 1) / num_frac;
-
-        int index = i * 4 / num_frac;
-        if (index != texture_index) 
-        {
-            render.destroy_texture_lazy(texture);
-
-            float f = float(index+1) / 4;
-            glm::vec4 texel[4] = {
-                {   f, 0.0,  0.0, 1.0 },
-                { 0.0,   f,  0.0, 1.0 },
-                { 0.0, 0.0,    f, 1.0 },
-                {   f, 1.0,  0.0, 1.0 },
-            };
-            texture = render.create_texture({ 2, 2, (uint8_t*)texel});
-
-            texture_index = index;
-        }
-
-        render.uniform(data);
-        render.texture(texture);
-        render.draw((vertex_t*)vertices, 6, indices, 6);
-	}
-    render.end_frame();
+    width = new_width;
+    height = new_height;
+    resize_tracker.poke();
 }
 
 int main(void)
 {
-#if USE_CORE_PROFILE
+#if USE_CORE_PROFILE || USE_GLES
 auto imgui_init = ImGui_ImplGlfwGL3_Init;
 auto imgui_shutdown = ImGui_ImplGlfwGL3_Shutdown;
 auto imgui_newframe = ImGui_ImplGlfwGL3_NewFrame;
@@ -1161,20 +60,33 @@ auto imgui_shutdown = ImGui_ImplGlfwGL2_Shutdown;
 auto imgui_newframe = ImGui_ImplGlfwGL2_NewFrame;
 #endif
 
-#if USE_CORE_PROFILE
+#if USE_CORE_PROFILE && !USE_GLES
     int gl_version_major = 4;
     int gl_version_minor = 1;
     int profile = GLFW_OPENGL_CORE_PROFILE;
     int forward = GLFW_TRUE;
-#   if USE_GLES
-    gl_version_major = 2;
-    gl_version_minor = 0;
-#   endif
+#elif USE_GLES
+    // es 3.0 is the floor the ubo path needs (vaos, uniform buffers,
+    // glBindBufferRange); 2.0 would only carry the gl2 renderer
+    int gl_version_major = 3;
+    int gl_version_minor = 0;
 #else
     int gl_version_major = 2;
     int gl_version_minor = 1;
 #endif
 
+    // stamp the first half of the tsc calibration before anything else;
+    // the second half runs once startup has provided the interval
+    cpu_clock.setup();
+
+    // saved tuning overrides apply before anything sizes itself off
+    // the defaults
+    tuning_load();
+
+    // serial cold-start phases; the breakdown prints once the first
+    // frame is up and lands in trace.json dumps
+    startup_profiler.phase("glfw init");
+
     glfwSetErrorCallback(error_callback);
 
     if (!glfwInit())
@@ -1185,17 +97,52 @@ auto imgui_newframe = ImGui_ImplGlfwGL2_NewFrame;
     client_api = GLFW_OPENGL_ES_API;
 #endif
 
-    glfwWindowHint(GLFW_SAMPLES, 4);
+    // no backbuffer msaa: aa moved to the offscreen scene target, where
+    // the profiler can change sample count and scale at runtime instead
+    // of paying forced 4x at native resolution
+    glfwWindowHint(GLFW_SAMPLES, 0);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, gl_version_major);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, gl_version_minor);
     glfwWindowHint(GLFW_CLIENT_API, client_api);
-#if USE_CORE_PROFILE
+#if USE_GLES
+    // es over glx/wgl is emulation where it exists at all; egl is what
+    // the embedded fleet (mali/adreno) actually runs, and glfw only
+    // takes that path when asked
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+#if USE_CORE_PROFILE && !USE_GLES
     glfwWindowHint(GLFW_OPENGL_PROFILE, profile);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, forward);
 #endif
+#if USE_GL_DEBUG_OUTPUT
+    // a real debug context, so the callback fires with useful detail
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#else
+    // KHR_no_error: per-call driver validation off for production. any
+    // error is undefined behavior instead of a GL_ERROR, which is what
+    // the debug builds above exist to catch first
+    glfwWindowHint(GLFW_CONTEXT_NO_ERROR, GLFW_TRUE);
+#endif
+#if USE_PARTIAL_REDRAW
+    // retained backbuffer: single-buffered, so rendered pixels survive
+    // the present and a partial redraw has something to draw over (the
+    // EGL equivalent would be EGL_BUFFER_PRESERVED)
+    glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_FALSE);
+#endif
+
+    startup_profiler.phase("window + context");
 
+    // robustness first, so glGetGraphicsResetStatus actually reports a
+    // device reset instead of always NO_ERROR; not every driver offers
+    // the strategy, and the watchdog degrades to stall detection only
+    glfwWindowHint(GLFW_CONTEXT_ROBUSTNESS, GLFW_LOSE_CONTEXT_ON_RESET);
     GLFWwindow* window = glfwCreateWindow(640, 480, "uno", NULL, NULL);
     if (!window)
+    {
+        glfwWindowHint(GLFW_CONTEXT_ROBUSTNESS, GLFW_NO_ROBUSTNESS);
+        window = glfwCreateWindow(640, 480, "uno", NULL, NULL);
+    }
+    if (!window)
     {
         glfwTerminate();
         exit(EXIT_FAILURE);
@@ -1203,16 +150,45 @@ auto imgui_newframe = ImGui_ImplGlfwGL2_NewFrame;
 
     glfwMakeContextCurrent(window);
 
+    // imgui init makes no gl calls (the font upload is deferred to the
+    // first frame), so it runs first and the atlas rasterizes on a
+    // worker while glad resolves entry points and the renderer
+    // compiles its shaders; first NewFrame finds it baked and only
+    // uploads
+    startup_profiler.phase("imgui init");
+
+    imgui_init(window, false);
+
+    job_handle_t font_job = job_system.create([](void*) {
+        unsigned char* pixels = nullptr;
+        int atlas_width = 0, atlas_height = 0;
+        ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &atlas_width, &atlas_height);
+    }, nullptr);
+    job_system.submit(font_job);
+
+    startup_profiler.phase("glad load");
+
 #if USE_GLES
     gladLoadGLES2Loader((GLADloadproc)glfwGetProcAddress);
+#elif USE_SLIM_GL_LOADER
+    // only the entry points the renderers use; cuts the cold-start proc
+    // resolution from glad's full table to a curated hundred-odd
+    slim_gl_load((GLADloadproc)glfwGetProcAddress);
 #else
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 #endif
 
+#if USE_GL_CALL_COUNTER
+    // swap the counting thunks in before anything caches a pointer
+    gl_call_counter_install();
+#endif
+
     glfwSwapInterval(0);
     glfwSetKeyCallback(window, key_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwGetFramebufferSize(window, &width, &height); // the callback owns it from here
 
-    imgui_init(window, false);
+    startup_profiler.phase("gl caps + debug");
 
     glGetIntegerv(GL_SAMPLES, &samples);
     if (samples)
@@ -1222,100 +198,494 @@ auto imgui_newframe = ImGui_ImplGlfwGL2_NewFrame;
 
     trace("%s\n%s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
 
+#if USE_GL_DEBUG_OUTPUT
     glEnable(GL_DEBUG_OUTPUT);
+    // synchronous dispatch serializes the driver's worker threads; only
+    // debug builds pay for it, where the exact callstack matters
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     if (glDebugMessageCallback) {
         glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+        // notification spam is cut in the driver before it ever reaches
+        // the callback; floods of those cost milliseconds per frame
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
         glDebugMessageCallback(opengl_callback, nullptr);
     }
+#endif
 
-    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
-
-#if USE_CORE_PROFILE
-#   if USE_TEST_CODE
-    auto render = renderer_gl31_t();
+    // the USE_* defines pick the starting backend; the profiler UI can
+    // switch between available variants at runtime from there
+#if USE_GLES
+    // the ubo path maps straight onto es 3.0; the indirect and bindless
+    // variants hide themselves behind their null entry points
+    renderer_active = renderer_kind_gl3;
+#elif USE_CORE_PROFILE
+#   if USE_BINDLESS
+    renderer_active = renderer_kind_bindless;
+#   elif USE_GL43
+    renderer_active = renderer_kind_gl43;
+#   elif USE_INSTANCED
+    renderer_active = renderer_kind_gl33;
+#   elif USE_TEST_CODE
+    renderer_active = renderer_kind_gl31;
 #   else
-    auto render = renderer_gl3_t();
+    renderer_active = renderer_kind_gl3;
 #   endif
 #else
-    auto render = renderer_gl2_t();
+    renderer_active = renderer_kind_gl2;
 #endif
 
-    if (!render.setup()) {
+    startup_profiler.phase("renderer setup");
+
+    renderer_opengl_t* render = create_renderer(renderer_active);
+
+    if (render == nullptr || !render->setup()) {
+        delete render;
         glfwTerminate();
         exit(EXIT_SUCCESS);
     }
 
     // https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_timer_query.txt
 
-    GLuint query;
-    bool query_issued = false;
-    bool wait_gpu = false;
+    startup_profiler.phase("query setup");
+
+    gpu_timer_pool_t gpu_timers;
+    gpu_timers.setup();
+
+    // pipeline counters ride alongside the timers; different query
+    // targets, so both can be active across the same frame
+    gpu_stats_pool_t gpu_stats;
+    gpu_stats.setup();
+
+    // calibrate the gpu timestamp clock against the cpu timeline once so
+    // exported gpu spans line up with the cpu zones
+    // startup has burned enough wall time to derive the tsc rate; from
+    // here every instrumentation stamp is a tsc read
+    cpu_clock.calibrate();
+
+    int64_t gpu_to_cpu_us = 0;
+    if (glGetInteger64v && glQueryCounter)
+    {
+        GLint64 gpu_now_ns = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu_now_ns);
+        gpu_to_cpu_us = cpu_clock.now_us() - gpu_now_ns / 1000;
+    }
+
+    // the atlas must be baked before the first imgui_newframe uploads it
+    job_system.wait(font_job);
+
+    startup_profiler.phase("first frame");
+
     int running = GLFW_TRUE;
 
-    auto a = std::chrono::high_resolution_clock::now();
+    renderer_capture_t* capture = nullptr;
+
+    // one poll per frame for every operation spanning frames; see
+    // gpu_task.h. spawned tasks capture the loop locals by reference,
+    // which is safe because the scheduler never outlives the loop
+    gpu_task_scheduler_t gpu_tasks;
+
+    int64_t a = cpu_clock.now_us();
 
     while (running)
     {
-        glfwGetFramebufferSize(window, &width, &height);
-
-        if (!query_issued) {
-            glGenQueries(1, &query);
-            glBeginQuery(GL_TIME_ELAPSED, query);
-            query_issued = true;
+        // everything the rendered frame is a function of, plus the
+        // inputs that should wake the ui
+        double mouse_x = 0.0, mouse_y = 0.0;
+        glfwGetCursorPos(window, &mouse_x, &mouse_y);
+        int mouse_down = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+
+        uint64_t frame_hash = 1469598103934665603ull;
+        frame_hash = damage_tracker_t::mix(frame_hash, &num_frac, sizeof(num_frac));
+        frame_hash = damage_tracker_t::mix(frame_hash, &width, sizeof(width));
+        frame_hash = damage_tracker_t::mix(frame_hash, &height, sizeof(height));
+        frame_hash = damage_tracker_t::mix(frame_hash, &renderer_active, sizeof(renderer_active));
+        frame_hash = damage_tracker_t::mix(frame_hash, &mouse_x, sizeof(mouse_x));
+        frame_hash = damage_tracker_t::mix(frame_hash, &mouse_y, sizeof(mouse_y));
+        frame_hash = damage_tracker_t::mix(frame_hash, &mouse_down, sizeof(mouse_down));
+        frame_hash = damage_tracker_t::mix(frame_hash, &input_generation, sizeof(input_generation));
+
+        // sweeps, the auto workload, captures and pending switches keep
+        // the frame moving even while the hash holds
+        bool animating = sweep_runner.active || workload_controller.active
+            || capture != nullptr || capture_request_frames > 0
+            || renderer_switch_request >= 0;
+
+        if (!damage_tracker.update(frame_hash) && !animating)
+        {
+            // unchanged and already on screen: no geometry rebuild, no
+            // submission, no swap — idle until something happens. give
+            // back the 1 ms timer rate while parked; the pacer retakes
+            // it on the next paced frame
+            timer_environment.release();
+            glfwWaitEventsTimeout(0.1);
+            a = cpu_clock.now_us(); // idle time is not frame time
+            if (glfwWindowShouldClose(window))
+                running = GLFW_FALSE;
+            continue;
         }
 
-        auto cpu_tick = std::chrono::high_resolution_clock::now();
+#if USE_PARTIAL_REDRAW
+        // when only the ui moved (scene inputs hashed the same) the
+        // retained backbuffer still holds a correct scene everywhere
+        // outside the panel, so clip the whole frame to the union of the
+        // panel's previous and current rects. the scene pass still runs
+        // inside the rect — the translucent ui needs fresh pixels under
+        // it and a moving panel exposes background — but the fill is a
+        // window-sized pass no more
+        uint64_t scene_hash = 1469598103934665603ull;
+        scene_hash = damage_tracker_t::mix(scene_hash, &num_frac, sizeof(num_frac));
+        scene_hash = damage_tracker_t::mix(scene_hash, &width, sizeof(width));
+        scene_hash = damage_tracker_t::mix(scene_hash, &height, sizeof(height));
+        scene_hash = damage_tracker_t::mix(scene_hash, &renderer_active, sizeof(renderer_active));
+
+        static damage_tracker_t scene_tracker;
+        scene_tracker.armed = true;
+
+        bool partial_redraw = !scene_tracker.update(scene_hash) && !animating
+            && ui_damage_rect.w > 0.f;
+        if (partial_redraw)
+        {
+            ui_rect_t rect = ui_rect_union(ui_damage_rect, ui_damage_prev);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor((GLint)rect.x, (GLint)(height - rect.y - rect.h),
+                (GLsizei)rect.w, (GLsizei)rect.h);
+        }
+#endif
 
-        render_background_texture(render);
+        // present-from-texture composition, the signage workload: the
+        // scene parks in the offscreen target and a frame whose scene
+        // inputs hashed the same re-presents it with one blit plus the
+        // ui. presentation rate (cursor, overlay) decouples from content
+        // rate — the scene can cost whatever it costs once a minute.
+        // scale and samples are in the hash because changing them
+        // recreates the target's storage, which loses the content
+        uint64_t compose_hash = 1469598103934665603ull;
+        compose_hash = damage_tracker_t::mix(compose_hash, &num_frac, sizeof(num_frac));
+        compose_hash = damage_tracker_t::mix(compose_hash, &width, sizeof(width));
+        compose_hash = damage_tracker_t::mix(compose_hash, &height, sizeof(height));
+        compose_hash = damage_tracker_t::mix(compose_hash, &renderer_active, sizeof(renderer_active));
+        compose_hash = damage_tracker_t::mix(compose_hash, &stress_scene, sizeof(stress_scene));
+        compose_hash = damage_tracker_t::mix(compose_hash, &render_scale_pct, sizeof(render_scale_pct));
+        compose_hash = damage_tracker_t::mix(compose_hash, &render_samples, sizeof(render_samples));
+
+        static damage_tracker_t compose_tracker;
+        compose_tracker.armed = compose_from_target;
+
+        // churn scenes re-record every frame by design, and a target
+        // that is not there yet — first frame after the toggle, or a
+        // context without fbo support — has nothing to re-present
+        bool compose_present = !compose_tracker.update(compose_hash) && !animating
+            && stress_scene == stress_scene_gradient && render_target.active();
+
+        bool gpu_timed = gpu_timers.begin();
+        bool gpu_counted = gpu_stats.begin();
+
+        int64_t cpu_tick = cpu_clock.now_us();
+
+        if (compose_present)
+            present_from_target();
+        else
+            render_background_texture(*render);
+
+        int64_t cpu_tock = cpu_clock.now_us();
+        auto cpu_frame = static_cast<float>((cpu_tock - cpu_tick) / 1000.0);
+
+        // median-of-window readouts instead of the old 0.05 ema, which
+        // took ~60 frames to traverse a step; per_frame_sec measures in
+        // seconds, so its absolute step floor scales with it
+        static metric_smoother_t cpu_smoother;
+        static metric_smoother_t gpu_smoother;
+        static metric_smoother_t frame_smoother = { 0.25e-3f };
+        // idle is a percentage, so the relative step detector alone
+        // would trip on noise near zero; give it a wide absolute floor
+        static metric_smoother_t idle_smoother = { 5.f };
+
+        // a num_frac edit (the slider or the workload controller) is a
+        // step by definition; restart the windows instead of waiting for
+        // the outlier detector to notice
+        static int smoothed_frac = num_frac;
+        if (smoothed_frac != num_frac)
+        {
+            smoothed_frac = num_frac;
+            cpu_smoother.reset();
+            gpu_smoother.reset();
+            frame_smoother.reset();
+            idle_smoother.reset();
+        }
 
-        auto cpu_tock = std::chrono::high_resolution_clock::now();
-        auto cpu_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(cpu_tock - cpu_tick);
-        auto cpu_frame = static_cast<float>(cpu_elapsed.count() / 1000.0);
+        cpu_smoother.push(cpu_frame);
+        cpu_time = cpu_smoother.median();
+        frame_stats.cpu.push(cpu_frame);
 
-        cpu_time = glm::mix(cpu_time, cpu_frame, 0.05);
+        if (gpu_timed)
+            gpu_timers.end();
+        if (gpu_counted)
+            gpu_stats.end();
 
-        if (query_issued && !wait_gpu) {
-            glEndQuery(GL_TIME_ELAPSED);
-            wait_gpu = true;
-        }
+        while (gpu_stats.collect(pipeline_stats))
+            pipeline_stats_valid = true;
 
-        GLint stopTimerAvailable = 0;
-        if (glGetQueryObjectiv)
-            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &stopTimerAvailable);
+        static float gpu_frame_raw = 0.f;
 
-        if (stopTimerAvailable) {
-            GLuint64 result_time = 0;
-            if (glGetQueryObjectui64v)
-                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result_time);
-            wait_gpu = false;
-            query_issued = false;
+        GLuint64 result_time = 0;
+        GLuint64 result_timestamp = 0;
+        while (gpu_timers.collect(&result_time, &result_timestamp)) {
             auto gpu_frame = static_cast<float>(result_time / 1e6f);
 
-            gpu_time = glm::mix(gpu_time, gpu_frame, 0.05);
+            gpu_frame_raw = gpu_frame;
+            gpu_smoother.push(gpu_frame);
+            gpu_time = gpu_smoother.median();
+
+            // the headline rate divides by the fresh median, not a
+            // value still converging toward the previous workload
+            if (gpu_time > 0.f)
+                draws_per_sec = draw_count / (gpu_time * 1e-3f);
+
+            frame_stats.gpu.push(gpu_frame);
+            if (gpu_frame > 0.f)
+                frame_stats.draws.push(draw_count / (gpu_frame * 1e-3f));
+
+            if (result_timestamp != 0) {
+                int64_t end_us = (int64_t)(result_timestamp / 1000) + gpu_to_cpu_us;
+                int64_t duration_us = (int64_t)(result_time / 1000);
+                trace_exporter.add("gpu frame", end_us - duration_us, duration_us, 1);
+            }
+
+            // inter-frame gap: successive end timestamps span the whole
+            // wall interval, elapsed covers only the busy part; whatever
+            // is left the gpu spent starved between end_frame and the
+            // next submission. both results come off the same query
+            // ring, so consecutive collects are consecutive frames
+            static GLuint64 prev_end_ns = 0;
+            if (result_timestamp != 0 && prev_end_ns != 0 &&
+                result_timestamp > prev_end_ns)
+            {
+                auto span_ns = result_timestamp - prev_end_ns;
+                auto gap_ns = span_ns > result_time ? span_ns - result_time : 0;
+                idle_smoother.push(100.f * (float)gap_ns / (float)span_ns);
+                gpu_idle_pct = idle_smoother.median();
+            }
+            if (result_timestamp != 0)
+                prev_end_ns = result_timestamp;
+        }
 
-            draws_per_sec = draw_count / (gpu_time * 1e-3f);
+        // feed the sweep the raw, unsmoothed times; the gpu value lags
+        // by however many frames the timer queries are in flight
+        bool sweep_running = sweep_runner.active;
+        sweep_runner.frame_done(cpu_frame, gpu_frame_raw);
+
+        // a sweep that just finished becomes this session's rows in the
+        // perf history; recording loads the previous run first, so the
+        // profiler can diff the two
+        if (sweep_running && !sweep_runner.active)
+            perf_history.record(sweep_runner.results);
+
+        // a sweep owns num_frac while it runs
+        if (!sweep_runner.active)
+            workload_controller.update(gpu_frame_raw);
+
+        // policy over the pacer and the workload budget; a sweep needs
+        // the machine at full rate, so it pauses the governor too
+        if (!sweep_runner.active)
+            power_governor.update(cpu_tock);
+
+        gpu_telemetry.sample(cpu_tock);
+
+        if (trace_dump_requested) {
+            trace_dump_requested = false;
+            if (trace_exporter.dump("trace.json"))
+                trace("trace written to trace.json\n");
+            if (frame_stats.dump("frame_stats.csv"))
+                trace("window stats written to frame_stats.csv\n");
         }
 
         imgui_newframe();
-        render.render_ui();
-        auto b = std::chrono::high_resolution_clock::now();
-        auto c = std::chrono::duration_cast<std::chrono::microseconds>(b - a);
-        auto d = static_cast<float>(c.count() * 1e-6);
+        render->render_ui();
+        GL_CHECK_PHASE("ui");
+#if USE_PARTIAL_REDRAW
+        if (partial_redraw)
+            glDisable(GL_SCISSOR_TEST);
+        ui_damage_prev = ui_damage_rect;
+#endif
+        int64_t b = cpu_clock.now_us();
+        auto d = static_cast<float>((b - a) * 1e-6);
 
         a = b;
 
-        per_frame_sec = glm::mix(per_frame_sec, d, 0.05);
+        frame_smoother.push(d);
+        per_frame_sec = frame_smoother.median();
+
+        // raw values; the graph exists to show what the medians hide
+        frame_history.push(cpu_frame, gpu_frame_raw, d * 1000.f);
+        frame_stats.frame.push(d * 1000.f);
+
+        // the detector reads the same raw frame time the graph shows;
+        // the hotkey fires the identical path by hand
+        hitch_capture.frame_done(d * 1000.f);
+        if (capture_trigger_requested) {
+            capture_trigger_requested = false;
+            hitch_capture.trigger();
+        }
+
+        {
+            PROFILE_ZONE("swap");
+#if USE_PARTIAL_REDRAW
+            // single-buffered: the frame is already in the front buffer,
+            // a flush pushes it out and the pixels persist for next time
+            glFlush();
+#else
+            glfwSwapBuffers(window);
+#endif
+        }
+
+        // fence this present against any input stamp the poll below
+        // delivered last iteration, and retire finished samples
+        latency_tracker.frame();
 
-        glfwSwapBuffers(window);
+        // mirror outputs consume the scene target the main present just
+        // resolved; one scheduler tick walks every open window
+        if (mirror_windows.any())
+        {
+            PROFILE_ZONE("mirror");
+            mirror_windows.present();
+        }
+
+        // everything this frame submitted is behind the fence the
+        // watchdog issues here; a stall or a device reset gets logged
+        // with the last frame's zone tree as the post-mortem
+        gl_watchdog.frame();
+        if (gl_watchdog.context_lost() && renderer_switch_request < 0)
+        {
+            // a reset leaves every gl object invalid; recovery rides
+            // the renderer-switch path, which already tears down and
+            // rebuilds the active backend between frames
+            renderer_switch_request = renderer_active;
+        }
+
+        // closes the "first frame" phase and prints the breakdown; a
+        // no-op on every later frame
+        startup_profiler.finish();
+
+        // with a frame on screen, fill the program binary cache for
+        // every backend this context could run; see
+        // shader_cache_warmer_t. later launches and backend switches
+        // then hit the disk cache instead of compiling
+        static shader_cache_warmer_t cache_warmer;
+        static bool cache_warming = false;
+        if (!cache_warming)
+        {
+            cache_warming = true;
+            cache_warmer.queue_known();
+            gpu_tasks.spawn().await([&]() { return cache_warmer.step(); });
+        }
+
+        {
+            PROFILE_ZONE("pace");
+            frame_pacer.pace();
+        }
         glfwPollEvents();
+
+        // wrap the live backend in the capture decorator on request and
+        // unwrap once the recording completes
+        if (capture_request_frames > 0)
+        {
+            if (capture == nullptr)
+            {
+                capture = new renderer_capture_t(render);
+                if (capture->begin("capture.bin", capture_request_frames))
+                {
+                    render = capture;
+                    trace("capturing %d frames to capture.bin\n", capture_request_frames);
+
+                    // the rest of the lifecycle as a task: wait out the
+                    // recording, then unwrap — no per-frame done flag
+                    // checks strewn through the loop
+                    gpu_tasks.spawn()
+                        .await([&]() { return capture->done(); })
+                        .then([&]() {
+                            render = capture->inner;
+                            delete capture;
+                            capture = nullptr;
+                            trace("capture complete\n");
+                        });
+                }
+                else
+                {
+                    delete capture;
+                    capture = nullptr;
+                }
+            }
+            capture_request_frames = 0;
+        }
+        gpu_tasks.tick();
+
+        // apply a backend switch requested from the UI between frames;
+        // a failed setup falls back to the one that was running; held
+        // off while a capture is wrapped around the live renderer
+        if (renderer_switch_request >= 0 && capture == nullptr)
+        {
+            int kind = renderer_switch_request;
+            renderer_switch_request = -1;
+
+            render->cleanup();
+            delete render;
+
+            // scene handles belonged to the renderer that just went away
+            stress_resources.reset();
+
+            render = create_renderer(kind);
+            if (render != nullptr && render->setup())
+            {
+                renderer_active = kind;
+            }
+            else
+            {
+                trace("%s failed to set up, reverting\n", renderer_kind_names[kind]);
+                delete render;
+                render = create_renderer(renderer_active);
+                if (render == nullptr || !render->setup())
+                {
+                    delete render;
+                    render = nullptr;
+                    running = GLFW_FALSE;
+                }
+            }
+        }
+
         if (glfwWindowShouldClose(window))
             running = GLFW_FALSE;
     }
 
-    render.cleanup();
+    trace_exporter.dump("trace.json");
+
+    // quitting mid-capture: close the stream and drop the decorator so
+    // the backend below gets the normal teardown
+    if (capture != nullptr)
+    {
+        render = capture->inner;
+        capture->writer.end();
+        delete capture;
+        capture = nullptr;
+    }
+
+    gpu_timers.cleanup();
+    gpu_stats.cleanup();
+    gl_watchdog.cleanup();
+    latency_tracker.cleanup();
+    gpu_telemetry.cleanup();
+    if (render != nullptr)
+    {
+        render->cleanup();
+        delete render;
+    }
+
+#if USE_GL_OBJECT_TRACKER
+    // everything tracked should be gone by now; survivors are leaks
+    gl_tracker.report("shutdown");
+#endif
 
 	imgui_shutdown();
+    mirror_windows.cleanup();
     glfwHideWindow(window);
     glfwDestroyWindow(window);
 
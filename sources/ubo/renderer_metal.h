@@ -0,0 +1,203 @@
+#ifndef __RENDERER_METAL_H__
+#define __RENDERER_METAL_H__
+
+#include "renderer.h"
+
+#if USE_METAL
+
+#include "renderer_metal_bridge.h"
+
+// explicit-api comparison point: the same renderer abstraction over a
+// MTLRenderCommandEncoder instead of gl. recording mirrors gl3 (the
+// shared draw_list_t plus per-draw uniform/texture streams); submission
+// copies the frame's streams once into an in-flight ring slot and binds
+// each draw's block by 256-aligned buffer offset, the metal analogue of
+// the glBindBufferRange path. the gl-only base facilities (imgui pass,
+// texture array, eviction) stay out of scope, so the base class is
+// bypassed everywhere it would touch gl
+class renderer_metal_t : public renderer_opengl_t
+{
+public:
+
+    bool setup() override
+    {
+        memset(metal_textures, 0xff, sizeof(metal_textures)); // all -1
+        if (native_window == nullptr)
+            return false;
+        return metal_bridge_setup(native_window, width, height);
+    }
+
+    void begin_frame() override
+    {
+        // no renderer_opengl_t::begin_frame: the clear and viewport live
+        // in the render pass descriptor on the bridge side
+        frame_arena.reset();
+        draw_list.reset();
+        uniforms_capacity.reseat(uniforms);
+        bind_textures.reset();
+
+        const float clear_color[4] = { 0.3f, 0.3f, 0.5f, 1.f };
+        metal_bridge_begin_frame(width, height, clear_color);
+    }
+
+    void uniform(const uniform_t& uniform) override
+    {
+        uniforms.push_back(uniform);
+    }
+
+    void texture(texture_handle_t texture) override
+    {
+        bind_textures.push_back(texture);
+    }
+
+    void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) override
+    {
+        draw_list.draw(vertices, vertex_count, indices, index_count);
+    }
+
+    void draw_quad(vertex_t* quad) override
+    {
+        draw_list.draw_quad(quad);
+    }
+
+    void submit(draw_desc_t&& desc) override
+    {
+        uniforms.push_back(desc.block);
+        bind_textures.push_back(desc.texture);
+        draw_list.draw_quad(desc.quad);
+    }
+
+    draw_list_t* parallel_draw_list() override { return &draw_list; }
+
+    void end_frame() override
+    {
+        {
+            PROFILE_ZONE("upload");
+            metal_bridge_upload(draw_list.vertices.data(), sizeof(vertex_t) * draw_list.vertices.size(),
+                draw_list.indices.data(), draw_list.indices.size(),
+                uniforms.data(), uniforms.size());
+        }
+
+        PROFILE_ZONE("submit");
+        for (int32_t i = 0; i < (int32_t)draw_list.commands.size(); i++)
+        {
+            const auto& command = draw_list.commands[i];
+            metal_bridge_draw(command.offset, command.count, i,
+                metal_textures[handle_index(bind_textures[i].index)]);
+        }
+        draw_count = (uint32_t)draw_list.commands.size();
+
+        metal_bridge_end_frame();
+        collect(false);
+    }
+
+    // the ui passes are gl; the bench harness runs this backend headless
+    void render_ui() override {}
+    void render_profile_ui() override {}
+
+    // same content-addressed sharing as the gl side, so the band churn
+    // (a handful of creates and releases per frame) resolves to cache
+    // hits instead of driver allocations
+    texture_handle_t create_texture(const texture_desc_t& desc) override
+    {
+        uint64_t key = hash_texture_desc(desc);
+        for (auto& entry : texture_cache)
+        {
+            if (entry.key == key)
+            {
+                entry.refcount++;
+                return { entry.handle };
+            }
+        }
+
+        texture_handle_t handle = { handle_alloc.alloc() };
+        if (handle.index == invalid_handle_t)
+            return handle;
+
+        metal_textures[handle_index(handle.index)] =
+            metal_bridge_create_texture(desc.width, desc.height, (const float*)desc.data);
+        texture_cache.push_back({ key, handle.index, 1 });
+        return handle;
+    }
+
+    void destroy_texture(texture_handle_t handle) override
+    {
+        if (handle.index == invalid_handle_t)
+            return;
+
+        for (size_t i = 0; i < texture_cache.size(); i++)
+        {
+            if (texture_cache[i].handle == handle.index)
+            {
+                if (--texture_cache[i].refcount > 0)
+                    return;
+                texture_cache[i] = texture_cache.back();
+                texture_cache.pop_back();
+                break;
+            }
+        }
+
+        int32_t& slot = metal_textures[handle_index(handle.index)];
+        metal_bridge_destroy_texture(slot);
+        slot = -1;
+        handle_alloc.free(handle.index);
+    }
+
+    // destroy_texture_lazy rides the base's deferred_frees untouched;
+    // the deferral is what lets the per-frame band churn keep hitting
+    // the content cache (the refcount only drops once the entry ages
+    // out), same as the gl collect. only the actual free differs
+    void collect(bool flush)
+    {
+        frame_number++;
+
+        if (deferred_frees.empty())
+            return;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < deferred_frees.size(); i++)
+        {
+            deferred_free_t entry = deferred_frees[i];
+            bool ready = (frame_number - entry.frame > free_defer_frames);
+            if (!flush && !ready)
+            {
+                deferred_frees[kept++] = entry;
+                continue;
+            }
+            destroy_texture(entry.handle);
+        }
+        deferred_frees.resize(kept);
+    }
+
+    void cleanup() override
+    {
+        // no renderer_opengl_t::cleanup: everything it frees is gl
+        collect(true);
+        for (uint32_t i = 0; i < max_texture; i++)
+        {
+            if (metal_textures[i] >= 0)
+            {
+                metal_bridge_destroy_texture(metal_textures[i]);
+                metal_textures[i] = -1;
+            }
+        }
+        texture_cache.clear();
+        metal_bridge_shutdown();
+    }
+
+    // set by the host before setup(): the NSWindow* from
+    // glfwGetCocoaWindow on a GLFW_NO_API window
+    void* native_window = nullptr;
+
+    draw_list_t draw_list;
+    small_vector_t<texture_handle_t, 16> bind_textures;
+    frame_vector_t<uniform_t> uniforms;
+    capacity_slot_t uniforms_capacity;
+
+    // bridge texture slot per handle; -1 when the slot is empty
+    int32_t metal_textures[max_texture];
+};
+
+#endif // USE_METAL
+
+#endif // __RENDERER_METAL_H__
@@ -0,0 +1,319 @@
+// metal backend bridge: the only objective-c++ translation unit in the
+// tree. renderer_metal.h (header-only c++, included by the main TU)
+// drives it through the c interface in renderer_metal_bridge.h; nothing
+// here includes renderer.h, so the single-TU-per-executable layout and
+// its anonymous-namespace globals stay intact. compiled with -fobjc-arc
+
+#include "renderer_metal_bridge.h"
+
+#if USE_METAL
+
+#import <Metal/Metal.h>
+#import <QuartzCore/CAMetalLayer.h>
+#import <AppKit/AppKit.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// msl mirror of the gl3 scene shader: same vertex passthrough, same
+// fragment math, so the metal rows compare against the gl ones
+static const char* shader_source = R"__(
+#include <metal_stdlib>
+using namespace metal;
+
+struct vertex_in
+{
+    float2 position [[attribute(0)]];
+    float2 texcoord [[attribute(1)]];
+};
+
+struct vertex_out
+{
+    float4 position [[position]];
+    float2 texcoord;
+};
+
+struct fragment_block
+{
+    float4 data[4];
+};
+
+vertex vertex_out vertex_main(vertex_in in [[stage_in]])
+{
+    vertex_out out;
+    out.position = float4(in.position, 0.0, 1.0);
+    out.texcoord = in.texcoord;
+    return out;
+}
+
+fragment float4 fragment_main(vertex_out in [[stage_in]],
+                              constant fragment_block& block [[buffer(0)]],
+                              texture2d<float> band [[texture(0)]])
+{
+    constexpr sampler nearest(filter::nearest, address::clamp_to_edge);
+    return band.sample(nearest, in.texcoord) * float4(1.0 + 0.05 * float3(block.data[0].r), 1.0);
+}
+)__";
+
+namespace {
+
+    // macOS wants constant-buffer offsets 256-byte aligned, the same
+    // figure desktop gl drivers report for UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    const size_t uniform_stride = 256;
+    const size_t uniform_block_bytes = 16 * sizeof(float);
+    const int in_flight_frames = 3;
+
+    struct frame_buffers_t
+    {
+        id<MTLBuffer> vertices;
+        id<MTLBuffer> indices;
+        id<MTLBuffer> uniforms;
+    };
+
+    id<MTLDevice> device;
+    id<MTLCommandQueue> queue;
+    CAMetalLayer* layer;
+    id<MTLRenderPipelineState> pipeline;
+    dispatch_semaphore_t in_flight;
+
+    frame_buffers_t frame_buffers[in_flight_frames];
+    int frame_index;
+
+    id<MTLCommandBuffer> command_buffer;
+    id<MTLRenderCommandEncoder> encoder;
+    id<CAMetalDrawable> drawable;
+
+    // bridge-side texture table; slots recycle through the free list.
+    // arc plus the encoder's own retention keep a destroyed texture
+    // alive until every in-flight frame referencing it completes
+    std::vector<id<MTLTexture>> textures;
+    std::vector<int32_t> free_slots;
+
+    int32_t bound_texture;
+}
+
+bool metal_bridge_setup(void* ns_window, int width, int height)
+{
+    device = MTLCreateSystemDefaultDevice();
+    if (device == nil)
+        return false;
+    queue = [device newCommandQueue];
+
+    NSWindow* window = (__bridge NSWindow*)ns_window;
+    layer = [CAMetalLayer layer];
+    layer.device = device;
+    layer.pixelFormat = MTLPixelFormatBGRA8Unorm;
+    layer.framebufferOnly = YES;
+    layer.drawableSize = CGSizeMake(width, height);
+    window.contentView.wantsLayer = YES;
+    window.contentView.layer = layer;
+
+    NSError* error = nil;
+    id<MTLLibrary> library = [device newLibraryWithSource:[NSString stringWithUTF8String:shader_source]
+                                                  options:nil
+                                                    error:&error];
+    if (library == nil)
+    {
+        fprintf(stderr, "metal: shader compile failed: %s\n", error.localizedDescription.UTF8String);
+        return false;
+    }
+
+    // vertex fetch rides buffer index 1, leaving 0 for stage constants
+    MTLVertexDescriptor* vertex_layout = [MTLVertexDescriptor vertexDescriptor];
+    vertex_layout.attributes[0].format = MTLVertexFormatFloat2;
+    vertex_layout.attributes[0].offset = 0;
+    vertex_layout.attributes[0].bufferIndex = 1;
+    vertex_layout.attributes[1].format = MTLVertexFormatFloat2;
+    vertex_layout.attributes[1].offset = 2 * sizeof(float);
+    vertex_layout.attributes[1].bufferIndex = 1;
+    vertex_layout.layouts[1].stride = 4 * sizeof(float);
+
+    MTLRenderPipelineDescriptor* pipeline_desc = [MTLRenderPipelineDescriptor new];
+    pipeline_desc.vertexFunction = [library newFunctionWithName:@"vertex_main"];
+    pipeline_desc.fragmentFunction = [library newFunctionWithName:@"fragment_main"];
+    pipeline_desc.vertexDescriptor = vertex_layout;
+    pipeline_desc.colorAttachments[0].pixelFormat = MTLPixelFormatBGRA8Unorm;
+
+    pipeline = [device newRenderPipelineStateWithDescriptor:pipeline_desc error:&error];
+    if (pipeline == nil)
+    {
+        fprintf(stderr, "metal: pipeline creation failed: %s\n", error.localizedDescription.UTF8String);
+        return false;
+    }
+
+    in_flight = dispatch_semaphore_create(in_flight_frames);
+    frame_index = 0;
+    bound_texture = -1;
+    return true;
+}
+
+void metal_bridge_begin_frame(int width, int height, const float clear_color[4])
+{
+    dispatch_semaphore_wait(in_flight, DISPATCH_TIME_FOREVER);
+    frame_index = (frame_index + 1) % in_flight_frames;
+
+    if (layer.drawableSize.width != width || layer.drawableSize.height != height)
+        layer.drawableSize = CGSizeMake(width, height);
+
+    drawable = [layer nextDrawable];
+    command_buffer = [queue commandBuffer];
+
+    // the clear is part of the pass instead of a separate call
+    MTLRenderPassDescriptor* pass = [MTLRenderPassDescriptor renderPassDescriptor];
+    pass.colorAttachments[0].texture = drawable.texture;
+    pass.colorAttachments[0].loadAction = MTLLoadActionClear;
+    pass.colorAttachments[0].storeAction = MTLStoreActionStore;
+    pass.colorAttachments[0].clearColor = MTLClearColorMake(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+
+    encoder = [command_buffer renderCommandEncoderWithDescriptor:pass];
+    [encoder setRenderPipelineState:pipeline];
+    bound_texture = -1;
+}
+
+// shared-storage allocations grow by doubling and are never shrunk; at
+// steady state the ring slot is written straight through the cpu cache
+static id<MTLBuffer> ensure_buffer(id<MTLBuffer> buffer, size_t bytes)
+{
+    if (buffer != nil && buffer.length >= bytes)
+        return buffer;
+
+    size_t rounded = 4096;
+    while (rounded < bytes)
+        rounded *= 2;
+    return [device newBufferWithLength:rounded options:MTLResourceStorageModeShared];
+}
+
+void metal_bridge_upload(const void* vertices, size_t vertex_bytes,
+                         const uint32_t* indices, size_t index_count,
+                         const void* uniform_blocks, size_t uniform_count)
+{
+    if (encoder == nil)
+        return;
+
+    frame_buffers_t& frame = frame_buffers[frame_index];
+
+    frame.vertices = ensure_buffer(frame.vertices, vertex_bytes);
+    memcpy(frame.vertices.contents, vertices, vertex_bytes);
+
+    frame.indices = ensure_buffer(frame.indices, index_count * sizeof(uint32_t));
+    memcpy(frame.indices.contents, indices, index_count * sizeof(uint32_t));
+
+    // blocks spread out to the aligned stride during the copy, so every
+    // draw below is a pure offset rebind into one buffer
+    frame.uniforms = ensure_buffer(frame.uniforms, uniform_count * uniform_stride);
+    char* out = (char*)frame.uniforms.contents;
+    for (size_t i = 0; i < uniform_count; i++)
+        memcpy(out + i * uniform_stride, (const char*)uniform_blocks + i * uniform_block_bytes, uniform_block_bytes);
+
+    [encoder setVertexBuffer:frame.vertices offset:0 atIndex:1];
+    if (uniform_count > 0)
+        [encoder setFragmentBuffer:frame.uniforms offset:0 atIndex:0];
+}
+
+void metal_bridge_draw(int32_t index_offset, int32_t index_count,
+                       int32_t uniform_index, int32_t texture_slot)
+{
+    if (encoder == nil)
+        return;
+
+    if (texture_slot >= 0 && texture_slot != bound_texture)
+    {
+        [encoder setFragmentTexture:textures[texture_slot] atIndex:0];
+        bound_texture = texture_slot;
+    }
+
+    [encoder setFragmentBufferOffset:uniform_index * uniform_stride atIndex:0];
+
+    [encoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+                        indexCount:(NSUInteger)index_count
+                         indexType:MTLIndexTypeUInt32
+                       indexBuffer:frame_buffers[frame_index].indices
+                 indexBufferOffset:(NSUInteger)index_offset * sizeof(uint32_t)];
+}
+
+void metal_bridge_end_frame()
+{
+    if (encoder == nil)
+        return;
+
+    [encoder endEncoding];
+    if (drawable != nil)
+        [command_buffer presentDrawable:drawable];
+
+    dispatch_semaphore_t semaphore = in_flight;
+    [command_buffer addCompletedHandler:^(id<MTLCommandBuffer>) {
+        dispatch_semaphore_signal(semaphore);
+    }];
+    [command_buffer commit];
+
+    encoder = nil;
+    command_buffer = nil;
+    drawable = nil;
+}
+
+int32_t metal_bridge_create_texture(int width, int height, const float* rgba)
+{
+    MTLTextureDescriptor* desc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA32Float
+                                                                                    width:(NSUInteger)width
+                                                                                   height:(NSUInteger)height
+                                                                                mipmapped:NO];
+    desc.usage = MTLTextureUsageShaderRead;
+
+    id<MTLTexture> texture = [device newTextureWithDescriptor:desc];
+    if (texture == nil)
+        return -1;
+
+    [texture replaceRegion:MTLRegionMake2D(0, 0, width, height)
+               mipmapLevel:0
+                 withBytes:rgba
+               bytesPerRow:(NSUInteger)width * 4 * sizeof(float)];
+
+    int32_t slot;
+    if (!free_slots.empty())
+    {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        textures[slot] = texture;
+    }
+    else
+    {
+        slot = (int32_t)textures.size();
+        textures.push_back(texture);
+    }
+    return slot;
+}
+
+void metal_bridge_destroy_texture(int32_t slot)
+{
+    if (slot < 0 || slot >= (int32_t)textures.size())
+        return;
+
+    textures[slot] = nil;
+    free_slots.push_back(slot);
+}
+
+void metal_bridge_shutdown()
+{
+    // drain the ring so nothing the gpu still reads gets released
+    if (in_flight != nil)
+    {
+        for (int i = 0; i < in_flight_frames; i++)
+            dispatch_semaphore_wait(in_flight, DISPATCH_TIME_FOREVER);
+        for (int i = 0; i < in_flight_frames; i++)
+            dispatch_semaphore_signal(in_flight);
+    }
+
+    textures.clear();
+    free_slots.clear();
+    for (int i = 0; i < in_flight_frames; i++)
+        frame_buffers[i] = frame_buffers_t();
+
+    pipeline = nil;
+    layer = nil;
+    queue = nil;
+    device = nil;
+    in_flight = nil;
+}
+
+#endif // USE_METAL
@@ -0,0 +1,35 @@
+#ifndef __RENDERER_METAL_BRIDGE_H__
+#define __RENDERER_METAL_BRIDGE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// narrow c-style seam between the header-only c++ renderer and the one
+// objective-c++ translation unit (renderer_metal.mm). each executable
+// here is a single c++ TU that includes renderer.h, so the metal code
+// cannot include it back without duplicating its anonymous-namespace
+// globals; everything crosses this boundary as raw pointers and fixed
+// layouts instead (vertex_t = 4 floats, uniform_t = 16 floats, 32-bit
+// indices, rgba32f texels)
+
+bool metal_bridge_setup(void* ns_window, int width, int height);
+void metal_bridge_shutdown();
+
+void metal_bridge_begin_frame(int width, int height, const float clear_color[4]);
+
+// the whole frame's streams, copied once into the in-flight ring slot
+void metal_bridge_upload(const void* vertices, size_t vertex_bytes,
+                         const uint32_t* indices, size_t index_count,
+                         const void* uniform_blocks, size_t uniform_count);
+
+// one draw: an index range, the uniform block selected by ring offset
+// and the texture slot returned by metal_bridge_create_texture
+void metal_bridge_draw(int32_t index_offset, int32_t index_count,
+                       int32_t uniform_index, int32_t texture_slot);
+
+void metal_bridge_end_frame();
+
+int32_t metal_bridge_create_texture(int width, int height, const float* rgba);
+void metal_bridge_destroy_texture(int32_t slot);
+
+#endif // __RENDERER_METAL_BRIDGE_H__
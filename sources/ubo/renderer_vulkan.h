@@ -0,0 +1,217 @@
+#ifndef __RENDERER_VULKAN_H__
+#define __RENDERER_VULKAN_H__
+
+#include "renderer.h"
+
+#if USE_VULKAN
+
+#include "renderer_vulkan_bridge.h"
+
+// explicit-api comparison point against the gl driver thread: the same
+// renderer abstraction over vulkan. recording mirrors gl3 (the shared
+// draw_list_t plus per-draw uniform/texture streams), geometry streams
+// into the acquired image's host-visible buffer pair, and the 64-byte
+// block rides each draw as push constants instead of a bound buffer
+// range. the bridge pre-records one command buffer per swapchain image;
+// while the scene generation holds, frame_cached short-circuits and
+// end_frame resubmits the recorded buffer without touching the gpu
+// streams at all - the vulkan analogue of the gl3 replay path, one
+// level lower. the gl-only base facilities (imgui pass, texture array,
+// eviction) stay out of scope, so the base class is bypassed everywhere
+// it would touch gl
+class renderer_vulkan_t : public renderer_opengl_t
+{
+public:
+
+    bool setup() override
+    {
+        memset(vulkan_textures, 0xff, sizeof(vulkan_textures)); // all -1
+        if (host_window == nullptr)
+            return false;
+        return vulkan_bridge_setup(host_window);
+    }
+
+    void begin_frame() override
+    {
+        // no renderer_opengl_t::begin_frame: the clear and viewport live
+        // in the render pass on the bridge side, and the swapchain image
+        // is acquired in frame_cached where the generation is known
+        frame_arena.reset();
+        draw_list.reset();
+        uniforms_capacity.reseat(uniforms);
+        bind_textures.reset();
+    }
+
+    // the acquire happens here: the bridge needs the generation to know
+    // whether the image's recorded command buffer can simply resubmit,
+    // and the scene calls this right after begin_frame in either case
+    bool frame_cached(int generation) override
+    {
+        const float clear_color[4] = { 0.3f, 0.3f, 0.5f, 1.f };
+        replay = vulkan_bridge_begin_frame(generation, clear_color);
+        return replay;
+    }
+
+    void uniform(const uniform_t& uniform) override
+    {
+        uniforms.push_back(uniform);
+    }
+
+    void texture(texture_handle_t texture) override
+    {
+        bind_textures.push_back(texture);
+    }
+
+    void draw(vertex_t* vertices, int vertex_count, index_t* indices, int index_count) override
+    {
+        draw_list.draw(vertices, vertex_count, indices, index_count);
+    }
+
+    void draw_quad(vertex_t* quad) override
+    {
+        draw_list.draw_quad(quad);
+    }
+
+    void submit(draw_desc_t&& desc) override
+    {
+        uniforms.push_back(desc.block);
+        bind_textures.push_back(desc.texture);
+        draw_list.draw_quad(desc.quad);
+    }
+
+    draw_list_t* parallel_draw_list() override { return &draw_list; }
+
+    void end_frame() override
+    {
+        if (!replay)
+        {
+            {
+                PROFILE_ZONE("upload");
+                vulkan_bridge_upload(draw_list.vertices.data(), sizeof(vertex_t) * draw_list.vertices.size(),
+                    draw_list.indices.data(), draw_list.indices.size());
+            }
+
+            PROFILE_ZONE("record");
+            for (int32_t i = 0; i < (int32_t)draw_list.commands.size(); i++)
+            {
+                const auto& command = draw_list.commands[i];
+                vulkan_bridge_draw(command.offset, command.count, (const float*)&uniforms[i],
+                    vulkan_textures[handle_index(bind_textures[i].index)]);
+            }
+            draw_count = (uint32_t)draw_list.commands.size();
+        }
+
+        vulkan_bridge_end_frame();
+        collect(false);
+    }
+
+    // the ui passes are gl; the bench harness runs this backend headless
+    void render_ui() override {}
+    void render_profile_ui() override {}
+
+    // same content-addressed sharing as the gl side, so the band churn
+    // resolves to cache hits instead of staging uploads and queue waits
+    texture_handle_t create_texture(const texture_desc_t& desc) override
+    {
+        uint64_t key = hash_texture_desc(desc);
+        for (auto& entry : texture_cache)
+        {
+            if (entry.key == key)
+            {
+                entry.refcount++;
+                return { entry.handle };
+            }
+        }
+
+        texture_handle_t handle = { handle_alloc.alloc() };
+        if (handle.index == invalid_handle_t)
+            return handle;
+
+        vulkan_textures[handle_index(handle.index)] =
+            vulkan_bridge_create_texture(desc.width, desc.height, (const float*)desc.data);
+        texture_cache.push_back({ key, handle.index, 1 });
+        return handle;
+    }
+
+    void destroy_texture(texture_handle_t handle) override
+    {
+        if (handle.index == invalid_handle_t)
+            return;
+
+        for (size_t i = 0; i < texture_cache.size(); i++)
+        {
+            if (texture_cache[i].handle == handle.index)
+            {
+                if (--texture_cache[i].refcount > 0)
+                    return;
+                texture_cache[i] = texture_cache.back();
+                texture_cache.pop_back();
+                break;
+            }
+        }
+
+        int32_t& slot = vulkan_textures[handle_index(handle.index)];
+        vulkan_bridge_destroy_texture(slot);
+        slot = -1;
+        handle_alloc.free(handle.index);
+    }
+
+    // destroy_texture_lazy rides the base's deferred_frees untouched;
+    // same aging as the metal collect, so cache entries survive the
+    // per-frame band churn. an actual destroy also invalidates the
+    // bridge's recorded command buffers (they may bind the dead set)
+    void collect(bool flush)
+    {
+        frame_number++;
+
+        if (deferred_frees.empty())
+            return;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < deferred_frees.size(); i++)
+        {
+            deferred_free_t entry = deferred_frees[i];
+            bool ready = (frame_number - entry.frame > free_defer_frames);
+            if (!flush && !ready)
+            {
+                deferred_frees[kept++] = entry;
+                continue;
+            }
+            destroy_texture(entry.handle);
+        }
+        deferred_frees.resize(kept);
+    }
+
+    void cleanup() override
+    {
+        // no renderer_opengl_t::cleanup: everything it frees is gl
+        collect(true);
+        for (uint32_t i = 0; i < max_texture; i++)
+        {
+            if (vulkan_textures[i] >= 0)
+            {
+                vulkan_bridge_destroy_texture(vulkan_textures[i]);
+                vulkan_textures[i] = -1;
+            }
+        }
+        texture_cache.clear();
+        vulkan_bridge_shutdown();
+    }
+
+    // set by the host before setup(): a GLFW_NO_API window the bridge
+    // creates its surface and swapchain on
+    GLFWwindow* host_window = nullptr;
+
+    draw_list_t draw_list;
+    small_vector_t<texture_handle_t, 16> bind_textures;
+    frame_vector_t<uniform_t> uniforms;
+    capacity_slot_t uniforms_capacity;
+    bool replay = false;
+
+    // bridge texture slot per handle; -1 when the slot is empty
+    int32_t vulkan_textures[max_texture];
+};
+
+#endif // USE_VULKAN
+
+#endif // __RENDERER_VULKAN_H__
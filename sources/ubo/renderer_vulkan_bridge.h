@@ -0,0 +1,42 @@
+#ifndef __RENDERER_VULKAN_BRIDGE_H__
+#define __RENDERER_VULKAN_BRIDGE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// same seam as the metal bridge: the vulkan objects live in their own
+// translation unit (renderer_vulkan.cpp) behind a c-style interface, so
+// the header-only renderer and its anonymous-namespace globals stay in
+// the one TU each executable builds. layouts are fixed by convention:
+// vertex_t = 4 floats, uniform_t = 16 floats pushed as constants,
+// 32-bit indices, rgba32f texels
+
+typedef struct GLFWwindow GLFWwindow;
+
+bool vulkan_bridge_setup(GLFWwindow* window);
+void vulkan_bridge_shutdown();
+
+// acquires the next swapchain image. true means the image still holds
+// a command buffer recorded for this generation: recording and uploads
+// are skipped and end_frame resubmits the pre-recorded buffer
+bool vulkan_bridge_begin_frame(int generation, const float clear_color[4]);
+
+// the frame's geometry, written once into the image's host-visible pair
+void vulkan_bridge_upload(const void* vertices, size_t vertex_bytes,
+                          const uint32_t* indices, size_t index_count);
+
+// one draw: an index range, the 64-byte block as push constants and the
+// texture slot returned by vulkan_bridge_create_texture
+void vulkan_bridge_draw(int32_t index_offset, int32_t index_count,
+                        const float* block, int32_t texture_slot);
+
+void vulkan_bridge_end_frame();
+
+// last completed frame's gpu time from the in-buffer timestamp pair;
+// 0 while no result is available yet (or timestamps are unsupported)
+double vulkan_bridge_gpu_ms();
+
+int32_t vulkan_bridge_create_texture(int width, int height, const float* rgba);
+void vulkan_bridge_destroy_texture(int32_t slot);
+
+#endif // __RENDERER_VULKAN_BRIDGE_H__
@@ -0,0 +1,19 @@
+#version 450
+
+// vulkan mirror of the gl3 scene fragment shader; the uniform block
+// arrives as push constants instead of a bound buffer range
+
+layout(set = 0, binding = 0) uniform sampler2D u_sampler;
+
+layout(push_constant) uniform u_fragment
+{
+    vec4 data[4];
+} u_frag;
+
+layout(location = 0) in vec2 v_texcoord;
+layout(location = 0) out vec4 color_out;
+
+void main()
+{
+    color_out = texture(u_sampler, v_texcoord) * vec4(1.0 + 0.05 * u_frag.data[0].rrr, 1.0);
+}
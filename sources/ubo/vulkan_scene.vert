@@ -0,0 +1,13 @@
+#version 450
+
+// vulkan mirror of the gl3 scene vertex passthrough
+
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec2 a_texcoord;
+layout(location = 0) out vec2 v_texcoord;
+
+void main()
+{
+    v_texcoord = a_texcoord;
+    gl_Position = vec4(a_position, 0, 1);
+}